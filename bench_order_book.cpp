@@ -0,0 +1,343 @@
+#include "core/include/market_data_generator.h"
+#include "core/include/order_book.h"
+#include "core/include/order_book_manager.h"
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * Order book microbenchmarks
+ * Compares the std::map price engine with the tick ladder on hot-path operations
+ */
+
+using Engine = market_core::OrderBook::Config::Engine;
+
+static const char* engine_name(Engine engine)
+{
+    return engine == Engine::TICK_LADDER ? "tick ladder" : "price map";
+}
+
+static void configure(market_core::OrderBook& book, Engine engine, double tick_size)
+{
+    market_core::OrderBook::Config config;
+    config.engine = engine;
+    config.tick_size = tick_size;
+    config.ladder_window_ticks = 16384;
+    book.set_config(config);
+}
+
+static void print_result(const std::string& name, Engine engine, double ns_per_op)
+{
+    std::cout << "  " << std::left << std::setw(28) << name
+              << std::setw(14) << engine_name(engine)
+              << std::right << std::fixed << std::setprecision(1) << std::setw(10) << ns_per_op
+              << " ns/op" << std::endl;
+}
+
+// Fill a sparse bid side, then time deleting the top of book until it is empty.
+// Wide gaps between levels are the worst case for a ladder without an index.
+void bench_delete_top_of_book(Engine engine, int gap_ticks)
+{
+    constexpr double tick_size = 0.001;
+    constexpr int levels = 200;
+    constexpr int rounds = 2000;
+
+    market_core::OrderBook book(1003, "USDJPY");
+    configure(book, engine, tick_size);
+
+    std::chrono::nanoseconds elapsed { 0 };
+    volatile double sink = 0.0;
+
+    for (int round = 0; round < rounds; ++round) {
+        for (int i = 0; i < levels; ++i) {
+            market_core::PriceLevel level {};
+            level.price = 149.500 - i * gap_ticks * tick_size;
+            level.quantity = 1000000;
+            level.order_count = 1;
+            book.update_level(market_core::Side::BID, level);
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < levels; ++i) {
+            auto best = book.get_best_bid();
+            book.remove_level(market_core::Side::BID, *best);
+            sink = sink + *best;
+        }
+        elapsed += std::chrono::steady_clock::now() - start;
+    }
+
+    double ns_per_op = static_cast<double>(elapsed.count()) / (static_cast<double>(levels) * rounds);
+    print_result("delete top (gap " + std::to_string(gap_ticks) + " ticks)", engine, ns_per_op);
+}
+
+// Deep two-sided book, then time building full snapshots and copying the bid side
+void bench_snapshot_build(Engine engine)
+{
+    constexpr double tick_size = 0.00001;
+    constexpr int levels = 100;
+    constexpr int rounds = 20000;
+
+    market_core::OrderBook book(1001, "EURUSD");
+    configure(book, engine, tick_size);
+    for (int i = 0; i < levels; ++i) {
+        market_core::PriceLevel level {};
+        level.quantity = 1000000 + i;
+        level.order_count = 1;
+        level.price = 1.08500 - i * tick_size;
+        book.update_level(market_core::Side::BID, level);
+        level.price = 1.08510 + i * tick_size;
+        book.update_level(market_core::Side::ASK, level);
+    }
+
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        auto snapshot = book.create_snapshot_event();
+        sink = sink + snapshot->bid_levels.size();
+    }
+    auto snapshot_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    for (int round = 0; round < rounds; ++round) {
+        auto bids = book.get_bids();
+        sink = sink + bids.size();
+    }
+    auto copy_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    print_result("snapshot build (2x100 lvls)", engine, static_cast<double>(snapshot_ns.count()) / rounds);
+    print_result("get_bids copy (100 lvls)", engine, static_cast<double>(copy_ns.count()) / rounds);
+}
+
+// Replay-style throughput: a long interleaved stream of quote updates across
+// many instruments, applied one event at a time versus in batches
+static std::vector<std::shared_ptr<market_core::MarketEvent>> make_replay_stream(int instruments, size_t count)
+{
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> instrument_dist(0, instruments - 1);
+    std::uniform_int_distribution<int> tick_dist(0, 19);
+    std::uniform_int_distribution<int> action_dist(0, 9);
+
+    std::vector<std::shared_ptr<market_core::MarketEvent>> events;
+    events.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        auto quote = std::make_shared<market_core::QuoteEvent>(1000 + instrument_dist(rng));
+        quote->side = (i & 1) ? market_core::Side::ASK : market_core::Side::BID;
+        int ticks = tick_dist(rng);
+        quote->price = (quote->side == market_core::Side::BID) ? 1.08500 - ticks * 0.00001 : 1.08510 + ticks * 0.00001;
+        quote->action = action_dist(rng) == 0 ? market_core::UpdateAction::DELETE : market_core::UpdateAction::CHANGE;
+        quote->quantity = 1000000;
+        quote->order_count = 1;
+        events.push_back(quote);
+    }
+    return events;
+}
+
+static void setup_manager(market_core::OrderBookManager& manager, int instruments, Engine engine = Engine::TICK_LADDER)
+{
+    for (int i = 0; i < instruments; ++i) {
+        auto instrument = std::make_shared<market_core::Instrument>(1000 + i, "SYM" + std::to_string(i),
+            market_core::InstrumentType::FX_SPOT);
+        instrument->tick_size = 0.00001;
+        manager.add_instrument(instrument);
+
+        market_core::OrderBook::Config config;
+        config.engine = engine;
+        manager.create_order_book(1000 + i, config);
+    }
+}
+
+static void print_throughput(const std::string& name, size_t events, std::chrono::nanoseconds elapsed)
+{
+    double seconds = static_cast<double>(elapsed.count()) / 1e9;
+    std::cout << "  " << std::left << std::setw(28) << name
+              << std::right << std::fixed << std::setprecision(2) << std::setw(10) << events / seconds / 1e6
+              << " M events/s" << std::endl;
+}
+
+void bench_apply_throughput()
+{
+    constexpr int instruments = 64;
+    constexpr size_t event_count = 1000000;
+    auto events = make_replay_stream(instruments, event_count);
+
+    {
+        market_core::OrderBookManager manager;
+        setup_manager(manager, instruments);
+        auto start = std::chrono::steady_clock::now();
+        for (const auto& event : events) {
+            manager.apply_event(event);
+        }
+        print_throughput("apply_event (single)", event_count, std::chrono::steady_clock::now() - start);
+    }
+
+    for (size_t batch : { 64, 1024, 16384 }) {
+        market_core::OrderBookManager manager;
+        setup_manager(manager, instruments);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t offset = 0; offset < event_count; offset += batch) {
+            manager.apply_events(events.data() + offset, std::min(batch, event_count - offset));
+        }
+        print_throughput("apply_events (batch " + std::to_string(batch) + ")", event_count,
+            std::chrono::steady_clock::now() - start);
+    }
+}
+
+// Several threads each drive their own disjoint set of instruments
+void bench_manager_scaling(int threads)
+{
+    constexpr int instruments = 64;
+    constexpr size_t events_per_thread = 500000;
+
+    market_core::OrderBookManager manager;
+    setup_manager(manager, instruments);
+
+    std::vector<std::vector<std::shared_ptr<market_core::MarketEvent>>> streams;
+    for (int t = 0; t < threads; ++t) {
+        auto stream = make_replay_stream(instruments / threads, events_per_thread);
+        for (auto& event : stream) {
+            // Map onto this thread's instruments: t, t + threads, t + 2 * threads, ...
+            event->instrument_id = 1000 + (event->instrument_id - 1000) * threads + t;
+        }
+        streams.push_back(std::move(stream));
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&manager, &stream = streams[t]]() {
+            for (const auto& event : stream) {
+                manager.apply_event(event);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    print_throughput(std::to_string(threads) + " thread(s)", events_per_thread * threads,
+        std::chrono::steady_clock::now() - start);
+}
+
+// Generator-style lookups over a large universe: owning shared_ptr pair
+// versus the borrowed slot reference
+void bench_lookup(int instruments)
+{
+    constexpr size_t lookups = 2000000;
+
+    // Empty map-engine books keep a large universe small in memory
+    market_core::OrderBookManager manager;
+    setup_manager(manager, instruments, Engine::PRICE_MAP);
+
+    std::mt19937 rng(7);
+    std::uniform_int_distribution<int> instrument_dist(0, instruments - 1);
+    std::vector<uint32_t> ids(lookups);
+    for (auto& id : ids) {
+        id = 1000 + instrument_dist(rng);
+    }
+
+    volatile double sink = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t id : ids) {
+        auto [instrument, book] = manager.get_instrument_and_book(id);
+        sink = sink + instrument->tick_size;
+    }
+    auto shared_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t id : ids) {
+        auto ref = manager.get_book_ref(id);
+        sink = sink + ref.instrument->tick_size;
+    }
+    auto ref_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+
+    std::string suffix = " (" + std::to_string(instruments) + " instr)";
+    std::cout << "  " << std::left << std::setw(42) << "get_instrument_and_book" + suffix
+              << std::right << std::fixed << std::setprecision(1) << std::setw(8)
+              << static_cast<double>(shared_ns.count()) / lookups << " ns/op" << std::endl;
+    std::cout << "  " << std::left << std::setw(42) << "get_book_ref" + suffix
+              << std::right << std::fixed << std::setprecision(1) << std::setw(8)
+              << static_cast<double>(ref_ns.count()) / lookups << " ns/op" << std::endl;
+}
+
+void print_layout()
+{
+    std::cout << "  sizeof(PriceLevel)  " << sizeof(market_core::PriceLevel) << " bytes, "
+              << 64.0 / sizeof(market_core::PriceLevel) << " levels per 64-byte line" << std::endl;
+    std::cout << "  sizeof(QuoteEvent)  " << sizeof(market_core::QuoteEvent) << " bytes" << std::endl;
+}
+
+// Per-instrument generate_update against one generate_block call over the universe
+void bench_generation(int instruments)
+{
+    const size_t updates = std::max<size_t>(1000000, instruments);
+    const int rounds = static_cast<int>(updates / instruments);
+
+    for (bool block : { false, true }) {
+        auto manager = std::make_shared<market_core::OrderBookManager>();
+        setup_manager(*manager, instruments, Engine::PRICE_MAP);
+        auto ids = manager->get_all_instrument_ids();
+
+        market_core::MarketDataGenerator generator(manager);
+        generator.set_seed(7);
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < rounds; ++r) {
+            if (block) {
+                generator.generate_block(ids);
+            } else {
+                for (uint32_t id : ids) {
+                    generator.generate_update(id);
+                }
+            }
+        }
+        print_throughput(std::to_string(instruments) + (block ? " generate_block" : " generate_update"),
+            static_cast<size_t>(rounds) * instruments, std::chrono::steady_clock::now() - start);
+    }
+}
+
+int main()
+{
+    std::cout << "Order Book Benchmarks" << std::endl;
+    std::cout << "=====================" << std::endl;
+
+    std::cout << "\nDelete top of book, then find the next best:" << std::endl;
+    for (int gap : { 1, 10, 50 }) {
+        bench_delete_top_of_book(Engine::PRICE_MAP, gap);
+        bench_delete_top_of_book(Engine::TICK_LADDER, gap);
+    }
+
+
+    std::cout << "\nLayout:" << std::endl;
+    print_layout();
+
+    std::cout << "\nSnapshot build:" << std::endl;
+    bench_snapshot_build(Engine::PRICE_MAP);
+    bench_snapshot_build(Engine::TICK_LADDER);
+
+    std::cout << "\nReplay throughput (64 instruments, 1M quotes):" << std::endl;
+    bench_apply_throughput();
+
+    std::cout << "\nInstrument lookup:" << std::endl;
+    for (int instruments : { 64, 50000 }) {
+        bench_lookup(instruments);
+    }
+
+    std::cout << "\nManager scaling, disjoint instruments per thread ("
+              << std::thread::hardware_concurrency() << " hardware threads):" << std::endl;
+    for (int threads : { 1, 2, 4 }) {
+        bench_manager_scaling(threads);
+    }
+
+
+    std::cout << "\nEvent generation (seeded, no listeners):" << std::endl;
+    for (int instruments : { 1000, 10000, 100000 }) {
+        bench_generation(instruments);
+    }
+
+    return 0;
+}
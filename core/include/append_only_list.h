@@ -0,0 +1,85 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+namespace market_core {
+
+// Growable list with lock-free readers and stable element addresses.
+//
+// Elements are stored in fixed-size chunks that are never moved or freed
+// while the list lives, so a reader can hold a pointer to an element while
+// writers append. Writers must be serialised by the caller. An element is
+// visible to readers once size() covers it.
+template <typename T, size_t ChunkSize = 4096, size_t MaxChunks = 4096>
+class AppendOnlyList {
+public:
+    AppendOnlyList()
+        : chunks_(new std::atomic<T*>[MaxChunks])
+    {
+        for (size_t i = 0; i < MaxChunks; ++i) {
+            chunks_[i].store(nullptr, std::memory_order_relaxed);
+        }
+    }
+
+    ~AppendOnlyList()
+    {
+        for (size_t i = 0; i < MaxChunks; ++i) {
+            delete[] chunks_[i].load(std::memory_order_relaxed);
+        }
+    }
+
+    AppendOnlyList(const AppendOnlyList&) = delete;
+    AppendOnlyList& operator=(const AppendOnlyList&) = delete;
+
+    static constexpr size_t max_size() { return ChunkSize * MaxChunks; }
+
+    // Append (writers serialised by the caller). Returns the element's
+    // address, or nullptr once max_size() is reached.
+    T* push_back(T value)
+    {
+        return emplace_back([&value](T& element) { element = std::move(value); });
+    }
+
+    // Append a default-constructed element that init(T&) fills in before it
+    // becomes visible; for elements that cannot be moved (e.g. atomics)
+    template <typename Init>
+    T* emplace_back(Init&& init)
+    {
+        size_t index = size_.load(std::memory_order_relaxed);
+        if (index >= max_size()) {
+            return nullptr;
+        }
+
+        size_t chunk = index / ChunkSize;
+        T* slots = chunks_[chunk].load(std::memory_order_relaxed);
+        if (!slots) {
+            slots = new T[ChunkSize];
+            chunks_[chunk].store(slots, std::memory_order_release);
+        }
+
+        T* element = &slots[index % ChunkSize];
+        init(*element);
+        size_.store(index + 1, std::memory_order_release);
+        return element;
+    }
+
+    size_t size() const { return size_.load(std::memory_order_acquire); }
+
+    // Valid for index < size()
+    T& operator[](size_t index)
+    {
+        return chunks_[index / ChunkSize].load(std::memory_order_acquire)[index % ChunkSize];
+    }
+    const T& operator[](size_t index) const
+    {
+        return chunks_[index / ChunkSize].load(std::memory_order_acquire)[index % ChunkSize];
+    }
+
+private:
+    std::unique_ptr<std::atomic<T*>[]> chunks_;
+    std::atomic<size_t> size_ { 0 };
+};
+
+} // namespace market_core
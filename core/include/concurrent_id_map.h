@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace market_core {
+
+// Open-addressing map from 32-bit IDs to pointers with lock-free lookups.
+//
+// Writers must be serialised by the caller; readers never lock. Entries are
+// only added or overwritten, never erased one by one. When the table grows,
+// or is cleared, the old table is retired rather than freed, so a reader
+// still probing it stays safe. Retired tables are released with the map,
+// which is fine because the map is written rarely (registration time).
+template <typename T>
+class ConcurrentIdMap {
+public:
+    explicit ConcurrentIdMap(size_t initial_capacity = 64)
+    {
+        size_t capacity = 16;
+        while (capacity < initial_capacity * 2) {
+            capacity <<= 1;
+        }
+        tables_.push_back(std::make_unique<Table>(capacity));
+        table_.store(tables_.back().get(), std::memory_order_release);
+    }
+
+    ConcurrentIdMap(const ConcurrentIdMap&) = delete;
+    ConcurrentIdMap& operator=(const ConcurrentIdMap&) = delete;
+
+    // Lock-free lookup, nullptr when absent
+    T* find(uint32_t id) const
+    {
+        const Table* table = table_.load(std::memory_order_acquire);
+        uint64_t key = to_key(id);
+
+        for (size_t i = table->home(id);; i = (i + 1) & table->mask) {
+            uint64_t slot_key = table->slots[i].key.load(std::memory_order_acquire);
+            if (slot_key == key) {
+                return table->slots[i].value.load(std::memory_order_acquire);
+            }
+            if (slot_key == 0) {
+                return nullptr;
+            }
+        }
+    }
+
+    // Insert or overwrite (writers serialised by the caller)
+    void insert(uint32_t id, T* value)
+    {
+        Table* table = table_.load(std::memory_order_relaxed);
+        if ((size_ + 1) * 2 > table->mask + 1) {
+            table = grow(table);
+        }
+        if (put(*table, id, value)) {
+            ++size_;
+        }
+    }
+
+    // Drop every entry (writers serialised by the caller)
+    void clear()
+    {
+        Table* table = table_.load(std::memory_order_relaxed);
+        tables_.push_back(std::make_unique<Table>(table->mask + 1));
+        table_.store(tables_.back().get(), std::memory_order_release);
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> key { 0 }; // id + 1, 0 = empty
+        std::atomic<T*> value { nullptr };
+    };
+
+    struct Table {
+        explicit Table(size_t capacity)
+            : mask(capacity - 1)
+            , slots(new Slot[capacity])
+        {
+        }
+
+        size_t home(uint32_t id) const
+        {
+            return static_cast<size_t>((static_cast<uint64_t>(id) * 0x9E3779B97F4A7C15ull) >> 32) & mask;
+        }
+
+        size_t mask;
+        std::unique_ptr<Slot[]> slots;
+    };
+
+    std::atomic<Table*> table_ { nullptr };
+    std::vector<std::unique_ptr<Table>> tables_; // Current table plus retired ones
+    size_t size_ = 0;
+
+    static uint64_t to_key(uint32_t id) { return static_cast<uint64_t>(id) + 1; }
+
+    // Returns true if a new entry was created
+    static bool put(Table& table, uint32_t id, T* value)
+    {
+        uint64_t key = to_key(id);
+        for (size_t i = table.home(id);; i = (i + 1) & table.mask) {
+            uint64_t slot_key = table.slots[i].key.load(std::memory_order_relaxed);
+            if (slot_key == key) {
+                table.slots[i].value.store(value, std::memory_order_release);
+                return false;
+            }
+            if (slot_key == 0) {
+                // Value first, so a reader that sees the key also sees the value
+                table.slots[i].value.store(value, std::memory_order_release);
+                table.slots[i].key.store(key, std::memory_order_release);
+                return true;
+            }
+        }
+    }
+
+    Table* grow(Table* old_table)
+    {
+        auto bigger = std::make_unique<Table>((old_table->mask + 1) * 2);
+        for (size_t i = 0; i <= old_table->mask; ++i) {
+            uint64_t key = old_table->slots[i].key.load(std::memory_order_relaxed);
+            if (key != 0) {
+                put(*bigger, static_cast<uint32_t>(key - 1),
+                    old_table->slots[i].value.load(std::memory_order_relaxed));
+            }
+        }
+
+        Table* table = bigger.get();
+        tables_.push_back(std::move(bigger));
+        table_.store(table, std::memory_order_release);
+        return table;
+    }
+};
+
+} // namespace market_core
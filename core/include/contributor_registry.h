@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace market_core {
+
+// Interned contributor (market maker) identifier, 0 = no contributor
+using ContributorId = uint16_t;
+constexpr ContributorId NO_CONTRIBUTOR = 0;
+
+// Process-wide table mapping contributor strings to small integer IDs.
+//
+// Books and events carry the 2-byte ID instead of a std::string, so the hot
+// level and quote layouts stay trivially copyable. Interning happens when a
+// contributor is first seen; names are looked up again only when encoding.
+class ContributorRegistry {
+public:
+    static ContributorRegistry& instance();
+
+    // Returns the existing ID for the name or assigns the next one.
+    // Returns NO_CONTRIBUTOR for an empty name or when all IDs are in use.
+    ContributorId intern(const std::string& name);
+
+    // Empty string for NO_CONTRIBUTOR or an unknown ID
+    std::string name(ContributorId id) const;
+
+    size_t size() const;
+
+private:
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, ContributorId> ids_;
+    std::deque<std::string> names_; // Index = ID - 1
+};
+
+} // namespace market_core
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "market_data_generator.h"
+#include "market_event_record.h"
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace market_core {
+
+// Capture file: a fixed header followed by MarketEventRecord values exactly
+// as they sit in memory, so a mapped file can be read in place. Files are
+// only portable between builds with the same record layout and byte order;
+// the header records the layout size so a mismatch is refused.
+struct CaptureHeader {
+    char magic[8]; // "RSBECAP1"
+    uint32_t version;
+    uint32_t record_size; // sizeof(MarketEventRecord) of the writer
+    uint64_t record_count; // 0 = not finalised, use the file length
+    uint64_t reserved;
+};
+
+static_assert(sizeof(CaptureHeader) % alignof(MarketEventRecord) == 0, "records after the header must stay aligned");
+
+// Listener that appends every record it sees to a capture file. Register it
+// with MarketDataGenerator before generating to record a session. Writes go
+// through a fixed buffer; snapshots have no record form and are skipped.
+// Not thread-safe: attach it to one generator.
+class CaptureWriter : public IMarketEventListener {
+public:
+    CaptureWriter() = default;
+    ~CaptureWriter() override;
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    bool open(const std::string& path);
+    void close(); // Flushes and stores the final record count
+    bool is_open() const { return file_ != nullptr; }
+    uint64_t records_written() const { return records_written_; }
+
+    void write(const MarketEventRecord* records, size_t count);
+
+    void on_market_event(const std::shared_ptr<MarketEvent>& event) override;
+    void on_market_event(const MarketEventRecord& record) override { write(&record, 1); }
+    void on_market_events(const MarketEventRecord* records, size_t count) override { write(records, count); }
+
+private:
+    std::FILE* file_ = nullptr;
+    std::vector<MarketEventRecord> buffer_;
+    uint64_t records_written_ = 0;
+
+    void flush();
+};
+
+// Read-only memory mapping of a capture file. records() points straight
+// into the mapping; nothing is parsed or copied.
+class CaptureFile {
+public:
+    CaptureFile() = default;
+    ~CaptureFile();
+
+    CaptureFile(const CaptureFile&) = delete;
+    CaptureFile& operator=(const CaptureFile&) = delete;
+
+    // Returns false with a reason in error if the file cannot be mapped or
+    // was written with a different record layout
+    bool open(const std::string& path, std::string& error);
+    void close();
+
+    const MarketEventRecord* records() const { return records_; }
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+
+private:
+    void* mapping_ = nullptr;
+    size_t mapping_size_ = 0;
+    const MarketEventRecord* records_ = nullptr;
+    size_t count_ = 0;
+};
+
+} // namespace market_core
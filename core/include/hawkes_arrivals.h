@@ -0,0 +1,93 @@
+#pragma once
+
+#include "philox.h"
+#include <cstdint>
+#include <vector>
+
+namespace market_core {
+
+// Self-exciting arrival parameters. Every update raises the chance of more
+// updates shortly after, on the same instrument and across the market; the
+// excitation decays exponentially.
+struct HawkesParameters {
+    bool enabled = false;
+    double self_excitation = 0.5; // Expected follow-on updates on the same instrument per update
+    double cross_excitation = 0.1; // Expected follow-on updates on other instruments per update
+    double decay_per_second = 200.0; // Excitation decay rate; mean follow-on delay is 1/decay
+
+    // Expected updates triggered by one update; must stay below 1
+    double branching_ratio() const { return self_excitation + cross_excitation; }
+};
+
+// Multivariate Hawkes process over a set of instruments with an exponential
+// kernel, simulated ahead of time in windows.
+//
+// Uses the cluster representation: background updates arrive as a Poisson
+// process at mean_rate * (1 - branching ratio), on uniformly chosen
+// instruments; each update then has Poisson(self_excitation) children on
+// its own instrument and Poisson(cross_excitation) children on random
+// instruments, each after an Exp(decay) delay. The result is exactly a
+// Hawkes process with long-run rate mean_rate, but produced without
+// evaluating per-instrument intensities, so cost is independent of the
+// number of instruments. Children falling beyond a window are carried into
+// the next one.
+//
+// Output is a pure function of the seed. After the first few windows the
+// buffers stop growing and next() does not allocate.
+class HawkesArrivals {
+public:
+    struct Arrival {
+        uint64_t time_ns; // Since the start of the process
+        uint32_t instrument_id;
+    };
+
+    // A branching ratio of 1 or more is explosive; the excitations are
+    // scaled down to MAX_BRANCHING_RATIO instead
+    static constexpr double MAX_BRANCHING_RATIO = 0.99;
+
+    // mean_rate is updates per second over all instruments. Needs at least
+    // one instrument and a positive rate, otherwise next() never returns.
+    HawkesArrivals(const HawkesParameters& parameters, double mean_rate,
+        std::vector<uint32_t> instrument_ids, uint64_t seed);
+
+    // Arrivals in time order, computed a window at a time
+    const Arrival& next()
+    {
+        while (cursor_ == window_.size()) {
+            fill_window();
+        }
+        return window_[cursor_++];
+    }
+
+    const HawkesParameters& parameters() const { return parameters_; }
+    double mean_rate() const { return mean_rate_; }
+    double background_rate() const { return background_rate_; }
+    size_t instrument_count() const { return instrument_ids_.size(); }
+
+private:
+    // Event whose children have not been drawn yet
+    struct Pending {
+        double time_ns;
+        uint32_t index; // Into instrument_ids_
+    };
+
+    HawkesParameters parameters_;
+    double mean_rate_;
+    double background_rate_; // Per second, all instruments together
+    double window_ns_;
+    std::vector<uint32_t> instrument_ids_;
+    CounterRng rng_;
+
+    double window_start_ns_ = 0.0;
+    double next_background_ns_ = 0.0;
+    std::vector<Arrival> window_;
+    size_t cursor_ = 0;
+    std::vector<Pending> work_; // Events inside the window still to branch
+    std::vector<Pending> carried_; // Children past the window end
+
+    void fill_window();
+    uint32_t random_index();
+    double exponential(double rate_per_ns);
+};
+
+} // namespace market_core
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "market_events.h"
+#include <algorithm>
+#include <cmath>
 #include <map>
 #include <memory>
 #include <string>
@@ -81,6 +83,58 @@ protected:
     InstrumentType type_;
 };
 
+// Hot instrument fields in fixed slots. Resolved once from the instrument
+// and its property map when the instrument is registered with
+// OrderBookManager, so per-event code never searches the string-keyed maps;
+// those stay for cold configuration.
+struct InstrumentRuntime {
+    static constexpr int PRICE_EXPONENT = -9; // Exponent of wire price mantissas
+
+    InstrumentType type = InstrumentType::FX_SPOT;
+    double tick_size = 0.01;
+    int64_t tick_scale = 10000000; // tick_size as a mantissa at PRICE_EXPONENT
+    int8_t price_exponent = -2; // Decimal places of tick_size, negated
+    double initial_price = 100.0; // "initial_price" property
+    double initial_spread = 0.02; // "initial_spread" property, else two ticks
+    int32_t channel = 0; // "channel" property, 0 = global feeds
+
+    static InstrumentRuntime resolve(const Instrument& instrument)
+    {
+        InstrumentRuntime runtime;
+        runtime.type = instrument.get_type();
+        runtime.tick_size = instrument.tick_size > 0.0 ? instrument.tick_size : 0.01;
+        runtime.tick_scale = std::max<int64_t>(1, std::llround(runtime.tick_size * 1e9));
+
+        // Fewest decimals that represent the tick exactly
+        int decimals = 0;
+        while (decimals < -PRICE_EXPONENT && runtime.tick_scale % pow10(-PRICE_EXPONENT - decimals) != 0) {
+            ++decimals;
+        }
+        runtime.price_exponent = static_cast<int8_t>(-decimals);
+
+        runtime.initial_price = instrument.get_property<double>("initial_price").value_or(100.0);
+        runtime.initial_spread = instrument.get_property<double>("initial_spread").value_or(2.0 * runtime.tick_size);
+        runtime.channel = static_cast<int32_t>(instrument.get_property<int64_t>("channel").value_or(0));
+        return runtime;
+    }
+
+    int64_t to_ticks(double price) const { return std::llround(price / tick_size); }
+    double from_ticks(int64_t ticks) const { return static_cast<double>(ticks) * tick_size; }
+
+    // Exact for prices on the tick grid, unlike price * 1e9
+    int64_t to_mantissa(double price) const { return to_ticks(price) * tick_scale; }
+
+private:
+    static int64_t pow10(int exponent)
+    {
+        int64_t value = 1;
+        while (exponent-- > 0) {
+            value *= 10;
+        }
+        return value;
+    }
+};
+
 // Futures-specific instrument
 class FuturesInstrument : public Instrument {
 public:
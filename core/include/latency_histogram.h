@@ -0,0 +1,97 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+namespace market_core {
+
+// Fixed-size log-linear histogram for nanosecond latencies.
+//
+// Each power of two is split into SUB_BUCKETS linear buckets, so a reported
+// percentile is within 1/SUB_BUCKETS (6.25%) of the true value at any
+// magnitude. Recording is a few shifts and an increment; nothing is
+// allocated. Copy a histogram to take a checkpoint and use since() to get
+// the values recorded after it.
+class LatencyHistogram {
+public:
+    static constexpr int SUB_BUCKET_BITS = 4;
+    static constexpr uint64_t SUB_BUCKETS = 1ULL << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKETS = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void record(uint64_t value)
+    {
+        ++counts_[index_of(value)];
+        ++count_;
+        sum_ += value;
+        max_ = std::max(max_, value);
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t max() const { return max_; }
+    double mean() const { return count_ > 0 ? static_cast<double>(sum_) / static_cast<double>(count_) : 0.0; }
+
+    // Upper bound of the bucket holding the q-quantile, q in [0, 1]
+    uint64_t percentile(double q) const
+    {
+        if (count_ == 0) {
+            return 0;
+        }
+        auto rank = static_cast<uint64_t>(std::max(0.0, std::min(1.0, q)) * static_cast<double>(count_));
+        rank = std::max<uint64_t>(1, rank);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            seen += counts_[i];
+            if (seen >= rank) {
+                return std::min(max_, upper_bound_of(i));
+            }
+        }
+        return max_;
+    }
+
+    // Values recorded after earlier, which must be a copy of this histogram.
+    // The maximum is only known to bucket precision.
+    LatencyHistogram since(const LatencyHistogram& earlier) const
+    {
+        LatencyHistogram delta;
+        for (size_t i = 0; i < BUCKETS; ++i) {
+            delta.counts_[i] = counts_[i] - earlier.counts_[i];
+            if (delta.counts_[i] > 0) {
+                delta.max_ = std::min(max_, upper_bound_of(i));
+            }
+        }
+        delta.count_ = count_ - earlier.count_;
+        delta.sum_ = sum_ - earlier.sum_;
+        return delta;
+    }
+
+    void reset() { *this = LatencyHistogram {}; }
+
+private:
+    std::array<uint64_t, BUCKETS> counts_ {};
+    uint64_t count_ = 0;
+    uint64_t sum_ = 0;
+    uint64_t max_ = 0;
+
+    static size_t index_of(uint64_t value)
+    {
+        if (value < SUB_BUCKETS) {
+            return static_cast<size_t>(value);
+        }
+        int shift = 63 - __builtin_clzll(value) - SUB_BUCKET_BITS;
+        auto sub = static_cast<size_t>((value >> shift) & (SUB_BUCKETS - 1));
+        return static_cast<size_t>(shift + 1) * SUB_BUCKETS + sub;
+    }
+
+    static uint64_t upper_bound_of(size_t index)
+    {
+        if (index < SUB_BUCKETS) {
+            return index;
+        }
+        int shift = static_cast<int>(index / SUB_BUCKETS) - 1;
+        uint64_t lower = (SUB_BUCKETS + index % SUB_BUCKETS) << shift;
+        return lower + ((1ULL << shift) - 1);
+    }
+};
+
+} // namespace market_core
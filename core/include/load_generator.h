@@ -0,0 +1,124 @@
+#pragma once
+
+#include "hawkes_arrivals.h"
+#include "latency_histogram.h"
+#include "market_data_generator.h"
+#include "tsc_clock.h"
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace market_core {
+
+// Open-loop load driver for MarketDataGenerator.
+//
+// Every update has a scheduled send time derived from the profile alone;
+// if the pipeline falls behind, the driver keeps emitting back to back
+// until it catches up instead of stretching the schedule, so the offered
+// load does not drop when the consumer is slow. Time is read from the
+// TSC and the driver spins between sends.
+//
+// Lag and service time (how long generate_update took, i.e. book update
+// plus listener dispatch) are recorded per update in fixed histograms.
+class LoadGenerator {
+public:
+    struct Profile {
+        enum class Shape {
+            STEADY, // Evenly spaced at rate
+            SQUARE_WAVE, // peak_rate for duty_cycle of each period, rate otherwise
+            POISSON_BURSTS, // Bursts of burst_size back-to-back updates, Poisson arrivals, mean rate
+            HAWKES // Self-exciting arrivals at mean rate, using the generator's MarketConfig::hawkes
+        };
+
+        Shape shape = Shape::STEADY;
+        double rate = 1000.0; // Updates per second
+        double peak_rate = 0.0; // SQUARE_WAVE high phase, 0 = 4 x rate
+        uint64_t period_ns = 1000000000; // SQUARE_WAVE period
+        double duty_cycle = 0.5; // SQUARE_WAVE fraction at peak_rate
+        uint32_t burst_size = 32; // POISSON_BURSTS updates per burst
+        uint64_t seed = 1;
+
+        // Configured long-run average rate
+        double mean_rate() const;
+    };
+
+    struct Report {
+        uint64_t sent = 0;
+        double elapsed_seconds = 0.0;
+        double target_rate = 0.0; // Profile mean rate
+        double achieved_rate = 0.0;
+        double mean_lag_ns = 0.0; // Send time minus scheduled time
+        double max_lag_ns = 0.0;
+        double p99_lag_ns = 0.0;
+        double p50_service_ns = 0.0;
+        double p99_service_ns = 0.0;
+        double backlog_ns = 0.0; // How far the schedule is ahead of sending at the end
+    };
+
+    LoadGenerator(MarketDataGenerator& generator, std::vector<uint32_t> instrument_ids, const Profile& profile);
+
+    // Start the schedule now; called by the first run_until if needed
+    void start();
+
+    // Send every update due before deadline (a TscClock tick), spinning
+    // between sends. Returns the number sent.
+    size_t run_until(uint64_t deadline);
+    size_t run_for_ns(uint64_t ns) { return run_until(TscClock::now() + TscClock::from_ns(static_cast<double>(ns))); }
+
+    // Run the schedule at scale times the profile's pace from now on (a
+    // scenario phase). Applies to every shape; a square wave's period
+    // shrinks with it.
+    void set_rate_scale(double scale);
+    double rate_scale() const { return rate_scale_; }
+
+    Report report() const;
+    const Profile& profile() const { return profile_; }
+    uint64_t sent() const { return sent_; }
+    size_t instrument_count() const { return instrument_ids_.size(); }
+    const LatencyHistogram& lag_histogram() const { return lag_ns_; }
+    const LatencyHistogram& service_histogram() const { return service_ns_; }
+
+    static bool parse_shape(const std::string& name, Profile::Shape& shape);
+    static const char* shape_name(Profile::Shape shape);
+
+private:
+    MarketDataGenerator& generator_;
+    std::vector<uint32_t> instrument_ids_;
+    Profile profile_;
+
+    bool started_ = false;
+    uint64_t start_ticks_ = 0;
+    uint64_t last_ticks_ = 0;
+    double next_due_ = 0.0; // Schedule ticks since start, fractional to avoid drift
+
+    // Schedule time runs at rate_scale_ x wall time since scale_since_ticks_
+    double rate_scale_ = 1.0;
+    uint64_t scale_since_ticks_ = 0;
+    double schedule_base_ = 0.0; // Schedule ticks elapsed at scale_since_ticks_
+    size_t next_instrument_ = 0;
+    uint32_t burst_remaining_ = 0;
+
+    uint64_t sent_ = 0;
+    double lag_sum_ticks_ = 0.0;
+    uint64_t max_lag_ticks_ = 0;
+    double ns_per_tick_ = 1.0;
+    LatencyHistogram lag_ns_;
+    LatencyHistogram service_ns_;
+
+    std::mt19937_64 rng_;
+    std::exponential_distribution<> burst_gap_ { 1.0 };
+
+    // HAWKES: precomputed arrivals, the next one waiting to be sent
+    std::unique_ptr<HawkesArrivals> arrivals_;
+    uint32_t next_arrival_instrument_ = 0;
+
+    void advance_schedule();
+    double schedule_elapsed(uint64_t now) const
+    {
+        return schedule_base_ + static_cast<double>(now - scale_since_ticks_) * rate_scale_;
+    }
+};
+
+} // namespace market_core
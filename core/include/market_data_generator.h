@@ -1,12 +1,19 @@
 #pragma once
 
 #include "instrument.h"
+#include "market_event_record.h"
 #include "market_events.h"
 #include "order_book_manager.h"
+#include "hawkes_arrivals.h"
+#include "philox.h"
+#include <array>
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <random>
+#include <string>
 #include <vector>
 
 namespace market_core {
@@ -22,6 +29,8 @@ enum class MarketMode {
     STRESSED
 };
 
+constexpr size_t MARKET_MODE_COUNT = 7;
+
 // Market generation configuration
 struct MarketConfig {
     MarketMode mode = MarketMode::NORMAL;
@@ -33,6 +42,7 @@ struct MarketConfig {
     double book_depth_target = 5; // Target number of levels per side
     bool generate_implied = false; // Generate implied prices (CME)
     bool generate_statistics = true; // Generate OHLC stats
+    HawkesParameters hawkes; // Bursty arrivals for generate_batch and the HAWKES load profile
 };
 
 // Event listener interface
@@ -40,35 +50,106 @@ class IMarketEventListener {
 public:
     virtual ~IMarketEventListener() = default;
     virtual void on_market_event(const std::shared_ptr<MarketEvent>& event) = 0;
+
+    // Allocation-free path used by the generator. The default converts to a
+    // shared_ptr event; listeners on the hot path should override it.
+    virtual void on_market_event(const MarketEventRecord& record)
+    {
+        if (auto event = to_event(record)) {
+            on_market_event(event);
+        }
+    }
+
+    // Records produced together by MarketDataGenerator::generate_block
+    virtual void on_market_events(const MarketEventRecord* records, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            on_market_event(records[i]);
+        }
+    }
 };
 
 // Market data generator - protocol agnostic
 class MarketDataGenerator {
 public:
     MarketDataGenerator(std::shared_ptr<OrderBookManager> book_manager);
-    ~MarketDataGenerator() = default;
+    ~MarketDataGenerator();
 
     // Configuration
-    void set_config(const MarketConfig& config) { config_ = config; }
+    void set_config(const MarketConfig& config)
+    {
+        config_ = config;
+        batch_arrivals_.reset(); // Picks up the new Hawkes parameters
+        refresh_mode_configs();
+    }
     const MarketConfig& get_config() const { return config_; }
 
     // Set market mode presets
     void set_market_mode(MarketMode mode);
 
+    // Per-instrument modes, e.g. one channel stressed while the rest follow
+    // the global config. An instrument in mode M uses the global config with
+    // M's preset applied. AUCTION stops trades: entering it emits an
+    // OPENING_AUCTION status, leaving it emits an uncross trade at the mid
+    // and a CONTINUOUS_TRADING status. set_market_mode does the same for
+    // instruments without a mode of their own.
+    void set_instrument_mode(const std::vector<uint32_t>& instrument_ids, MarketMode mode);
+    void clear_instrument_modes(); // Everyone back to the global config
+    MarketMode get_instrument_mode(uint32_t instrument_id) const { return config_for(instrument_id).mode; }
+
+    // Mode names are the enumerator names, matched case-insensitively
+    static void apply_mode_preset(MarketMode mode, MarketConfig& config);
+    static bool parse_market_mode(const std::string& name, MarketMode& mode);
+    static const char* market_mode_name(MarketMode mode);
+
+    // Deterministic mode: each update draws from a Philox stream keyed by
+    // (seed, instrument ID, per-instrument update number), so an
+    // instrument's events depend only on the seed and its own history.
+    // Instruments can then be split across generators on different
+    // threads and still match a single-threaded run (timestamps aside).
+    void set_seed(uint64_t seed);
+    bool is_seeded() const { return seeded_; }
+
     // Event generation
     void generate_update(uint32_t instrument_id);
-    void generate_batch(int count);
+    void generate_batch(int count); // Uniform instruments, or clustered when config.hawkes.enabled
     void generate_all_instruments();
 
+    // One update for each listed instrument in a single pass. Random inputs
+    // are drawn first, then price moves (Box-Muller, drift, tick rounding)
+    // are computed over structure-of-arrays scratch, and the records are
+    // applied and dispatched in bulk. Instruments should be distinct; a
+    // repeat sees its book as of the start of the block. Seeded, the events
+    // match calling generate_update on each instrument in order. Returns the
+    // number of events emitted.
+    size_t generate_block(const uint32_t* instrument_ids, size_t count);
+    size_t generate_block(const std::vector<uint32_t>& instrument_ids)
+    {
+        return generate_block(instrument_ids.data(), instrument_ids.size());
+    }
+
     // Specific event generation
     std::shared_ptr<QuoteEvent> generate_quote(uint32_t instrument_id);
     std::shared_ptr<TradeEvent> generate_trade(uint32_t instrument_id);
     std::shared_ptr<StatisticsEvent> generate_statistics(uint32_t instrument_id);
     std::shared_ptr<SnapshotEvent> generate_snapshot(uint32_t instrument_id);
 
-    // Event listeners (protocols register here)
-    void add_listener(std::weak_ptr<IMarketEventListener> listener);
-    void remove_listener(std::shared_ptr<IMarketEventListener> listener);
+    // Same as generate_quote/generate_trade but fill a caller-owned record;
+    // return false when no event can be generated
+    bool generate_quote_record(uint32_t instrument_id, MarketEventRecord& record);
+    bool generate_trade_record(uint32_t instrument_id, MarketEventRecord& record);
+
+    // Event listeners (protocols register here).
+    //
+    // API change: add_listener used to take a weak_ptr and drop a listener
+    // once its owners released it. Dispatch now iterates strong references
+    // without touching reference counts, so the generator owns what is
+    // registered: a listener is notified, and kept alive, until
+    // remove_listener or clear_listeners. An owner that wants a listener to
+    // stop must deregister it explicitly; dropping its own reference is
+    // not enough.
+    void add_listener(std::shared_ptr<IMarketEventListener> listener);
+    bool remove_listener(const std::shared_ptr<IMarketEventListener>& listener); // False if not registered
     void clear_listeners();
 
     // Statistics
@@ -87,9 +168,19 @@ private:
     MarketConfig config_;
     Statistics stats_;
 
-    // Event listeners
-    std::vector<std::weak_ptr<IMarketEventListener>> listeners_;
-    std::mutex listeners_mutex_;
+    // Per-instrument modes; looked up only when non-empty
+    std::unordered_map<uint32_t, MarketMode> instrument_modes_;
+    std::array<MarketConfig, MARKET_MODE_COUNT> mode_configs_; // config_ plus each preset
+
+    // Event listeners. Dispatch loads the current snapshot and iterates it
+    // without locking; registration builds a new snapshot and swaps it in.
+    struct ListenerSnapshot {
+        std::vector<std::shared_ptr<IMarketEventListener>> listeners;
+    };
+    std::atomic<const ListenerSnapshot*> listener_snapshot_ { nullptr };
+    std::atomic<uint32_t> dispatches_in_flight_ { 0 };
+    std::mutex listeners_mutex_; // Serialises registration changes
+    std::vector<std::unique_ptr<const ListenerSnapshot>> retired_snapshots_; // Freed once no dispatch can see them
 
     // Random number generation
     std::mt19937 rng_;
@@ -97,14 +188,65 @@ private:
     std::normal_distribution<> normal_dist_ { 0.0, 1.0 };
     std::poisson_distribution<> poisson_dist_ { 3 };
 
+    // generate_block scratch, one entry per instrument in the block
+    struct BlockScratch {
+        enum Kind : uint8_t {
+            NONE,
+            QUOTE,
+            TRADE
+        };
+        std::vector<BookRef> refs;
+        std::vector<TopOfBook> tobs;
+        std::vector<uint8_t> kinds;
+        std::vector<Side> sides;
+        std::vector<UpdateAction> actions;
+        std::vector<uint32_t> sequences;
+        std::vector<uint64_t> quantities;
+        std::vector<double> reference_prices;
+        std::vector<double> tick_sizes;
+        std::vector<double> volatilities;
+        std::vector<double> drifts; // trend_bias * volatility
+        std::vector<double> normal_u1;
+        std::vector<double> normal_u2;
+        std::vector<double> prices;
+        std::vector<MarketEventRecord> records;
+
+        void resize(size_t count);
+    };
+    BlockScratch block_;
+
+    // Seeded mode state
+    bool seeded_ = false;
+    uint64_t seed_ = 0;
+    CounterRng event_rng_; // Stream of the update in progress
+    std::unordered_map<uint32_t, uint64_t> update_counts_;
+    uint64_t batch_count_ = 0;
+
+    // Instrument choice for generate_batch when config_.hawkes.enabled
+    std::unique_ptr<HawkesArrivals> batch_arrivals_;
+
     // Sequence tracking
     std::unordered_map<uint32_t, uint32_t> instrument_sequences_;
 
+    // Random draws; from event_rng_ when seeded, else from rng_
+    void begin_update(uint32_t instrument_id);
+    double next_uniform();
+    double next_normal();
+
     // Helper methods
     void notify_listeners(const std::shared_ptr<MarketEvent>& event);
-    double calculate_price_movement(double current_price, const Instrument& instrument);
-    uint64_t calculate_quantity(const Instrument& instrument);
-    bool should_generate_trade();
+    void notify_listeners(const MarketEventRecord& record);
+    template <typename Event>
+    void dispatch(const Event& event);
+    void dispatch_block(const MarketEventRecord* records, size_t count);
+    void publish_listeners(std::vector<std::shared_ptr<IMarketEventListener>> listeners);
+    std::vector<std::shared_ptr<IMarketEventListener>> current_listeners() const;
+    const MarketConfig& config_for(uint32_t instrument_id) const;
+    void refresh_mode_configs();
+    void change_mode(uint32_t instrument_id, MarketMode from, MarketMode to);
+    double calculate_price_movement(double current_price, const MarketConfig& config);
+    uint64_t calculate_quantity(const InstrumentRuntime& instrument);
+    bool should_generate_trade(const MarketConfig& config);
     Side choose_aggressor_side();
     UpdateAction choose_update_action();
     double apply_tick_rounding(double price, double tick_size) const;
@@ -0,0 +1,116 @@
+#pragma once
+
+#include "market_events.h"
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace market_core {
+
+// Fixed-size payloads carried by MarketEventRecord. Every field is a plain
+// scalar; "not set" is 0 (Side::NONE for sides), as in QuoteEvent.
+struct QuotePayload {
+    double price;
+    uint64_t quantity;
+    uint64_t order_id; // Non-zero for order-by-order updates
+    uint64_t implied_quantity; // For CME implied, 0 = none
+    uint32_t order_count;
+    Side side;
+    UpdateAction action;
+    uint8_t price_level; // For CME levels, 0 = not set
+    ContributorId contributor_id; // Interned Reuters contributor, 0 = none
+};
+
+struct TradePayload {
+    double price;
+    uint64_t quantity;
+    uint64_t trade_id; // Numeric trade ID, 0 = none
+    Side aggressor_side; // Side::NONE when unknown
+};
+
+struct StatisticsPayload {
+    double value;
+    uint64_t volume; // 0 = none
+    StatisticsEvent::StatType stat_type;
+};
+
+struct StatusPayload {
+    StatusEvent::Status status;
+    uint32_t halt_reason_code; // 0 = none
+};
+
+// Value-type market event: a common header plus a payload selected by type.
+//
+// Records are trivially copyable and never own heap memory, so they can be
+// built on the stack, passed by reference through the listener chain and
+// stored in flat arrays for batching or replay. SNAPSHOT has no record form
+// (its size is unbounded) and stays on the shared_ptr<SnapshotEvent> path.
+struct MarketEventRecord {
+    MarketEvent::EventType type;
+    uint32_t instrument_id;
+    uint64_t timestamp_ns;
+    uint32_t sequence_number;
+    uint32_t rpt_seq; // 0 = none
+
+    union {
+        QuotePayload quote; // QUOTE_UPDATE
+        TradePayload trade; // TRADE
+        StatisticsPayload statistics; // STATISTICS
+        StatusPayload status; // STATUS_CHANGE
+    };
+
+    static MarketEventRecord make_quote(uint32_t instrument_id)
+    {
+        MarketEventRecord record = make(MarketEvent::QUOTE_UPDATE, instrument_id);
+        record.quote.side = Side::BID;
+        record.quote.action = UpdateAction::ADD;
+        return record;
+    }
+
+    static MarketEventRecord make_trade(uint32_t instrument_id)
+    {
+        MarketEventRecord record = make(MarketEvent::TRADE, instrument_id);
+        record.trade.aggressor_side = Side::NONE;
+        return record;
+    }
+
+    static MarketEventRecord make_statistics(uint32_t instrument_id)
+    {
+        MarketEventRecord record = make(MarketEvent::STATISTICS, instrument_id);
+        record.statistics.stat_type = StatisticsEvent::CLOSE;
+        return record;
+    }
+
+    static MarketEventRecord make_status(uint32_t instrument_id)
+    {
+        MarketEventRecord record = make(MarketEvent::STATUS_CHANGE, instrument_id);
+        record.status.status = StatusEvent::CONTINUOUS_TRADING;
+        return record;
+    }
+
+    static MarketEventRecord make_book_clear(uint32_t instrument_id)
+    {
+        return make(MarketEvent::BOOK_CLEAR, instrument_id);
+    }
+
+private:
+    static MarketEventRecord make(MarketEvent::EventType type, uint32_t instrument_id)
+    {
+        MarketEventRecord record {};
+        record.type = type;
+        record.instrument_id = instrument_id;
+        return record;
+    }
+};
+
+static_assert(std::is_trivially_copyable<MarketEventRecord>::value, "MarketEventRecord must stay trivially copyable");
+static_assert(sizeof(MarketEventRecord) <= 80, "MarketEventRecord should stay close to a cache line");
+
+// Conversions to and from the polymorphic event classes, for code that still
+// works with shared_ptr<MarketEvent>. A TradeEvent's string trade ID survives
+// only if it is numeric; a StatusEvent's halt reason text is dropped.
+QuotePayload to_quote_payload(const QuoteEvent& quote);
+bool to_record(const MarketEvent& event, MarketEventRecord& record); // false for SNAPSHOT/IMBALANCE
+std::shared_ptr<MarketEvent> to_event(const MarketEventRecord& record);
+
+} // namespace market_core
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "contributor_registry.h"
 #include <cstdint>
 #include <optional>
 #include <string>
@@ -13,13 +14,13 @@ class Instrument;
 class OrderBook;
 
 // Common types across all protocols
-enum class Side {
+enum class Side : uint8_t {
     BID,
     ASK,
     NONE
 };
 
-enum class UpdateAction {
+enum class UpdateAction : uint8_t {
     ADD,
     CHANGE,
     DELETE,
@@ -67,27 +68,36 @@ public:
 };
 
 // Quote/Level update event
+//
+// Fields are ordered so the small ones fill the base class tail padding and
+// the hot ones sit in the first cache line. Protocol extras are plain scalars
+// with 0 meaning "not set", keeping the event free of heap-owning members.
 class QuoteEvent : public MarketEvent {
 public:
     Side side;
-    double price;
-    uint64_t quantity;
     UpdateAction action;
+    ContributorId contributor_id; // Interned Reuters contributor, 0 = none
+    uint8_t price_level; // For CME levels, 0 = not set
     uint32_t order_count;
+    double price;
+    uint64_t quantity;
+    uint64_t order_id; // Non-zero for order-by-order updates
 
     // Optional fields for different protocols
-    std::optional<uint8_t> price_level; // For CME levels
+    uint64_t implied_quantity; // For CME implied, 0 = none
     std::optional<uint32_t> rpt_seq; // For CME sequence
-    std::optional<std::string> market_maker_id; // For Reuters contributors
-    std::optional<uint64_t> implied_quantity; // For CME implied
 
     QuoteEvent(uint32_t instrument_id)
         : MarketEvent(EventType::QUOTE_UPDATE, instrument_id)
         , side(Side::BID)
-        , price(0.0)
-        , quantity(0)
         , action(UpdateAction::ADD)
+        , contributor_id(NO_CONTRIBUTOR)
+        , price_level(0)
         , order_count(0)
+        , price(0.0)
+        , quantity(0)
+        , order_id(0)
+        , implied_quantity(0)
     {
     }
 };
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace market_core {
+
+// Two-level occupancy index over a fixed number of slots.
+//
+// Each slot has a bit in words_, and each non-zero word has a bit in
+// summary_, so finding the next occupied slot in either direction is a
+// count-trailing/leading-zeros on at most one word per level instead of a
+// scan across empty slots. One summary word covers 4096 slots.
+class OccupancyBitmap {
+public:
+    static constexpr size_t npos = SIZE_MAX;
+
+    explicit OccupancyBitmap(size_t slots)
+        : slots_(slots)
+        , words_((slots + 63) / 64, 0)
+        , summary_((words_.size() + 63) / 64, 0)
+    {
+    }
+
+    size_t size() const { return slots_; }
+
+    bool test(size_t index) const
+    {
+        return (words_[index >> 6] >> (index & 63)) & 1;
+    }
+
+    void set(size_t index)
+    {
+        size_t word = index >> 6;
+        words_[word] |= uint64_t(1) << (index & 63);
+        summary_[word >> 6] |= uint64_t(1) << (word & 63);
+    }
+
+    void reset(size_t index)
+    {
+        size_t word = index >> 6;
+        words_[word] &= ~(uint64_t(1) << (index & 63));
+        if (words_[word] == 0) {
+            summary_[word >> 6] &= ~(uint64_t(1) << (word & 63));
+        }
+    }
+
+    void clear()
+    {
+        std::fill(words_.begin(), words_.end(), 0);
+        std::fill(summary_.begin(), summary_.end(), 0);
+    }
+
+    // Lowest occupied slot at or above index, or npos
+    size_t find_next(size_t index) const
+    {
+        if (index >= slots_) {
+            return npos;
+        }
+
+        size_t word = index >> 6;
+        uint64_t bits = words_[word] & (~uint64_t(0) << (index & 63));
+        if (bits) {
+            return (word << 6) + __builtin_ctzll(bits);
+        }
+
+        word = next_word(word + 1);
+        return word == npos ? npos : (word << 6) + __builtin_ctzll(words_[word]);
+    }
+
+    // Highest occupied slot at or below index, or npos
+    size_t find_prev(size_t index) const
+    {
+        if (index >= slots_) {
+            index = slots_ - 1;
+        }
+
+        size_t word = index >> 6;
+        uint64_t bits = words_[word] & (~uint64_t(0) >> (63 - (index & 63)));
+        if (bits) {
+            return (word << 6) + 63 - __builtin_clzll(bits);
+        }
+
+        if (word == 0) {
+            return npos;
+        }
+        word = prev_word(word - 1);
+        return word == npos ? npos : (word << 6) + 63 - __builtin_clzll(words_[word]);
+    }
+
+    size_t find_first() const { return find_next(0); }
+    size_t find_last() const { return slots_ == 0 ? npos : find_prev(slots_ - 1); }
+
+private:
+    size_t slots_;
+    std::vector<uint64_t> words_; // One bit per slot
+    std::vector<uint64_t> summary_; // One bit per non-empty word
+
+    // First non-empty word at or above word, or npos
+    size_t next_word(size_t word) const
+    {
+        size_t group = word >> 6;
+        if (group >= summary_.size()) {
+            return npos;
+        }
+
+        uint64_t bits = summary_[group] & (~uint64_t(0) << (word & 63));
+        while (!bits) {
+            if (++group >= summary_.size()) {
+                return npos;
+            }
+            bits = summary_[group];
+        }
+        return (group << 6) + __builtin_ctzll(bits);
+    }
+
+    // Last non-empty word at or below word, or npos
+    size_t prev_word(size_t word) const
+    {
+        size_t group = word >> 6;
+        uint64_t bits = summary_[group] & (~uint64_t(0) >> (63 - (word & 63)));
+        while (!bits) {
+            if (group == 0) {
+                return npos;
+            }
+            bits = summary_[--group];
+        }
+        return (group << 6) + 63 - __builtin_clzll(bits);
+    }
+};
+
+} // namespace market_core
@@ -1,37 +1,23 @@
 #pragma once
 
+#include "market_event_record.h"
 #include "market_events.h"
+#include "order_level_book.h"
+#include "price_ladder.h"
+#include "price_level.h"
+#include "top_of_book.h"
+#include "trade_history.h"
 #include <cstdint>
 #include <map>
 #include <memory>
 #include <optional>
 #include <string>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace market_core {
 
-// Price level in the order book
-struct PriceLevel {
-    double price;
-    uint64_t quantity;
-    uint32_t order_count;
-    uint64_t last_update_time;
-
-    // Optional protocol-specific fields
-    std::optional<uint64_t> implied_quantity; // For CME implied prices
-    std::optional<std::string> market_maker_id; // For Reuters contributors
-    std::optional<uint8_t> level_number; // Explicit level number for some protocols
-};
-
-// Trade information
-struct Trade {
-    double price;
-    uint64_t quantity;
-    uint64_t timestamp_ns;
-    std::optional<Side> aggressor_side;
-    std::optional<std::string> trade_id;
-};
-
 // Market statistics
 struct MarketStats {
     double open_price = 0.0;
@@ -65,10 +51,58 @@ public:
     // Trade operations
     void add_trade(const Trade& trade);
 
-    // Getters with configurable depth
+    // Order-by-order operations, available when Config::aggregate_by_price is
+    // false. Price levels are derived from the orders incrementally.
+    bool add_order(uint64_t order_id, Side side, double price, uint64_t quantity, uint64_t timestamp_ns = 0);
+    bool modify_order(uint64_t order_id, double price, uint64_t quantity, uint64_t timestamp_ns = 0);
+    bool cancel_order(uint64_t order_id);
+    const Order* get_order(uint64_t order_id) const;
+    size_t queue_position(uint64_t order_id) const; // 1-based, 0 if unknown
+    size_t order_count() const { return orders_ ? orders_->order_count() : 0; }
+    const OrderLevelBook* get_orders() const { return orders_.get(); }
+
+    // Implied quantity at a level (CME), kept apart from the hot level data.
+    // Recorded only when Config::maintain_implied_prices is set; 0 clears it.
+    void set_implied_quantity(Side side, double price, uint64_t quantity);
+    std::optional<uint64_t> get_implied_quantity(Side side, double price) const;
+
+    // Getters with configurable depth (copying; prefer visit_* on hot paths)
     std::vector<PriceLevel> get_bids(size_t max_levels = SIZE_MAX) const;
     std::vector<PriceLevel> get_asks(size_t max_levels = SIZE_MAX) const;
-    std::vector<Trade> get_recent_trades(size_t count = 10) const;
+    TradeHistoryView get_recent_trades(size_t count = 10) const; // Valid until the next trade
+
+    // Non-allocating depth access: calls fn(const PriceLevel&) for up to
+    // max_levels levels, best first. Levels must not be modified meanwhile.
+    template <typename Fn>
+    void visit_side(Side side, size_t max_levels, Fn&& fn) const
+    {
+        const PriceLadder* ladder = (side == Side::BID) ? bid_ladder_.get() : ask_ladder_.get();
+        if (ladder) {
+            ladder->for_each(max_levels, fn);
+            return;
+        }
+
+        size_t count = 0;
+        auto visit_map = [&](const auto& levels) {
+            for (const auto& [price, level] : levels) {
+                if (count >= max_levels)
+                    break;
+                fn(level);
+                ++count;
+            }
+        };
+        if (side == Side::BID) {
+            visit_map(bids_);
+        } else {
+            visit_map(asks_);
+        }
+    }
+
+    template <typename Fn>
+    void visit_bids(size_t max_levels, Fn&& fn) const { visit_side(Side::BID, max_levels, std::forward<Fn>(fn)); }
+
+    template <typename Fn>
+    void visit_asks(size_t max_levels, Fn&& fn) const { visit_side(Side::ASK, max_levels, std::forward<Fn>(fn)); }
 
     // Best prices
     std::optional<double> get_best_bid() const;
@@ -76,6 +110,13 @@ public:
     std::optional<double> get_mid_price() const;
     std::optional<double> get_spread() const;
 
+    // Lock-free BBO snapshot, safe to call from any thread while the book is updated
+    TopOfBook read_top_of_book() const { return top_of_book_.read(); }
+    uint64_t get_version() const { return version_; }
+
+    // Sequence number of the last event or record applied, 0 = none yet
+    uint64_t get_last_sequence() const { return last_sequence_; }
+
     // Statistics
     const MarketStats& get_stats() const { return stats_; }
     void update_stats(const MarketStats& stats) { stats_ = stats; }
@@ -86,19 +127,33 @@ public:
 
     // State queries
     bool is_crossed() const;
-    size_t bid_depth() const { return bids_.size(); }
-    size_t ask_depth() const { return asks_.size(); }
-    bool is_empty() const { return bids_.empty() && asks_.empty(); }
+    size_t bid_depth() const { return bid_ladder_ ? bid_ladder_->size() : bids_.size(); }
+    size_t ask_depth() const { return ask_ladder_ ? ask_ladder_->size() : asks_.size(); }
+    bool is_empty() const { return bid_depth() == 0 && ask_depth() == 0; }
 
     // Configuration for different protocols
     struct Config {
+        // Storage used for price levels
+        enum class Engine {
+            PRICE_MAP, // Ordered map keyed on price
+            TICK_LADDER // Contiguous tick-indexed array, needs a tick size
+        };
+
         size_t max_visible_levels = 10; // How many levels to maintain
         bool maintain_implied_prices = false; // For CME
         bool track_market_makers = false; // For Reuters
         bool aggregate_by_price = true; // Aggregate orders at same price
+        Engine engine = Engine::PRICE_MAP;
+        double tick_size = 0.0; // 0 = take the instrument's tick size
+        size_t ladder_window_ticks = 4096; // Ticks held per ladder side
+        size_t trade_history_capacity = 100; // Recent trades kept per book
     };
 
-    void set_config(const Config& config) { config_ = config; }
+    // Builds the book straight at its final size, without the default
+    // trade ring and ladders that set_config would replace
+    OrderBook(uint32_t instrument_id, const std::string& symbol, const Config& config);
+
+    void set_config(const Config& config);
     const Config& get_config() const { return config_; }
 
     // Generate snapshot event from current state
@@ -106,6 +161,23 @@ public:
 
     // Apply an event to the book
     void apply_event(const std::shared_ptr<MarketEvent>& event);
+    void apply_event(const MarketEvent& event);
+
+    // Apply a run of events for this book back to back. The BBO is published
+    // once at the end rather than after every change, so lock-free readers
+    // see the state between batches only.
+    void apply_events(const MarketEvent* const* events, size_t count);
+    void apply_events(const std::shared_ptr<MarketEvent>* events, size_t count);
+
+    // Value-type equivalents; no event objects are created
+    void apply_record(const MarketEventRecord& record);
+    void apply_records(const MarketEventRecord* records, size_t count);
+
+    // Bracket for callers interleaving several books' events: BBO publication
+    // is deferred until end_batch(). begin_batch() returns false if a batch is
+    // already open, so the caller knows not to close it twice.
+    bool begin_batch();
+    void end_batch();
 
 private:
     uint32_t instrument_id_;
@@ -116,12 +188,36 @@ private:
     std::map<double, PriceLevel, std::greater<double>> bids_; // Descending
     std::map<double, PriceLevel> asks_; // Ascending
 
-    std::vector<Trade> recent_trades_;
+    // Tick ladders, used instead of the maps when config_.engine is TICK_LADDER
+    std::unique_ptr<PriceLadder> bid_ladder_;
+    std::unique_ptr<PriceLadder> ask_ladder_;
+
+    // Individual orders, present when config_.aggregate_by_price is false
+    std::unique_ptr<OrderLevelBook> orders_;
+
+    // Cold per-level data, keyed by price_key(); usually empty
+    std::unordered_map<int64_t, uint64_t> implied_bids_;
+    std::unordered_map<int64_t, uint64_t> implied_asks_;
+
+    TradeRing recent_trades_;
     MarketStats stats_;
 
+    // BBO published for lock-free readers after every book change
+    TopOfBookCache top_of_book_;
+    uint64_t version_ = 0;
+    uint64_t last_sequence_ = 0;
+    bool defer_publish_ = false; // Inside apply_events
+    bool publish_pending_ = false;
+
     // Helper methods
+    const PriceLevel* best_level(Side side) const;
+    int64_t price_key(double price) const;
+    void publish_top_of_book();
     void update_stats_on_trade(const Trade& trade);
-    void apply_quote_event(const QuoteEvent& quote);
+    void apply_level_change(const OrderLevelBook::LevelChange& change);
+    void apply_quote(const QuotePayload& quote, uint64_t timestamp_ns);
+    void apply_order_quote(const QuotePayload& quote, uint64_t timestamp_ns);
+    void apply_trade(const TradePayload& trade, uint64_t timestamp_ns);
     void apply_trade_event(const TradeEvent& trade);
 };
 
@@ -1,18 +1,44 @@
 #pragma once
 
+#include "append_only_list.h"
+#include "concurrent_id_map.h"
 #include "instrument.h"
 #include "order_book.h"
+#include <atomic>
 #include <memory>
 #include <mutex>
-#include <unordered_map>
 #include <vector>
 
 namespace market_core {
 
-// Manages multiple order books and instruments
+// Borrowed handle to an instrument and its book. No reference counts are
+// touched to get one. Both pointers stay valid for the manager's lifetime:
+// instruments are never removed and books dropped by reset_all_books are
+// retained. Use the shared_ptr getters when ownership has to outlive it.
+struct BookRef {
+    const Instrument* instrument = nullptr;
+    OrderBook* book = nullptr; // nullptr when the instrument has no book
+    uint32_t slot = UINT32_MAX;
+    const InstrumentRuntime* runtime = nullptr; // Set whenever instrument is
+
+    explicit operator bool() const { return instrument && book; }
+};
+
+// Manages multiple order books and instruments.
+//
+// Each instrument gets a dense slot number at registration; instruments and
+// their books live in slot order, and lookups go through a lock-free ID to
+// slot index. Books are partitioned into shards by instrument ID, each with
+// its own lock, so threads driving disjoint instruments rarely contend. A
+// registry mutex only serialises the rare writers (registration and reset).
 class OrderBookManager {
 public:
-    OrderBookManager() = default;
+    static constexpr size_t DEFAULT_SHARD_COUNT = 16;
+    static constexpr size_t MAX_SHARD_COUNT = 64;
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+
+    // Shard count is rounded up to a power of two, at most MAX_SHARD_COUNT
+    explicit OrderBookManager(size_t shard_count = DEFAULT_SHARD_COUNT);
     ~OrderBookManager() = default;
 
     // Instrument management
@@ -32,27 +58,94 @@ public:
     std::pair<std::shared_ptr<Instrument>, std::shared_ptr<OrderBook>>
     get_instrument_and_book(uint32_t instrument_id) const;
 
+    // Borrowed, refcount-free lookups for hot paths. Slots are assigned in
+    // registration order, 0 .. instrument_count() - 1.
+    BookRef get_book_ref(uint32_t instrument_id) const;
+    BookRef get_book_ref_by_slot(uint32_t slot) const;
+    uint32_t get_slot(uint32_t instrument_id) const; // NO_SLOT if unknown
+    const InstrumentRuntime* get_runtime(uint32_t instrument_id) const; // nullptr if unknown
+
     // Bulk operations
     void clear_all_books();
     void reset_all_books();
-    size_t instrument_count() const { return instruments_.size(); }
-    size_t book_count() const { return order_books_.size(); }
+    size_t instrument_count() const { return slots_.size(); }
+    size_t book_count() const { return book_count_.load(std::memory_order_relaxed); }
+    size_t shard_count() const { return shard_mask_ + 1; }
 
     // Thread-safe event application
     void apply_event(const std::shared_ptr<MarketEvent>& event);
 
+    // Apply a contiguous run of events, taking each touched shard's lock once.
+    // A book is looked up only when the instrument changes between events and
+    // publishes its BBO once at the end. Returns the number of events that
+    // reached a book.
+    size_t apply_events(const std::shared_ptr<MarketEvent>* events, size_t count);
+    size_t apply_events(const std::vector<std::shared_ptr<MarketEvent>>& events)
+    {
+        return apply_events(events.data(), events.size());
+    }
+
+    // Value-type equivalents of apply_event/apply_events
+    void apply_record(const MarketEventRecord& record);
+    size_t apply_records(const MarketEventRecord* records, size_t count);
+
+    // Lock-free BBO read; never blocks the thread applying events
+    std::optional<TopOfBook> get_top_of_book(uint32_t instrument_id) const;
+
     // Generate events
     std::shared_ptr<SnapshotEvent> create_snapshot(
         uint32_t instrument_id,
         size_t max_levels = SIZE_MAX) const;
 
 private:
-    // Thread safety
-    mutable std::mutex mutex_;
+    // One lock per shard; aligned so neighbouring shard locks do not share a line
+    struct alignas(64) Shard {
+        mutable std::mutex mutex; // Serialises reads and writes of this shard's books
+        std::vector<std::shared_ptr<OrderBook>> books; // Live books, dense
+        std::vector<OrderBook*> batch_books; // Books touched by the batch in progress
+    };
+
+    std::unique_ptr<Shard[]> shards_;
+    size_t shard_mask_;
+
+    // Serialises registry writers; readers never take it
+    mutable std::mutex registry_mutex_;
+
+    // Per-instrument slot; the instrument and its runtime record are fixed
+    // once published, the book pointer changes on create_order_book and
+    // reset_all_books
+    struct InstrumentSlot {
+        std::shared_ptr<Instrument> instrument;
+        InstrumentRuntime runtime;
+        std::atomic<const std::shared_ptr<OrderBook>*> book { nullptr }; // Entry in book_storage_
+        uint32_t slot = NO_SLOT;
+    };
+
+    // Slots and books never move once stored, so the index can hand out
+    // pointers to them. Books dropped by reset_all_books stay in
+    // book_storage_, so a reader that looked one up just before never dangles.
+    AppendOnlyList<InstrumentSlot> slots_;
+    ConcurrentIdMap<InstrumentSlot> slot_index_;
+    AppendOnlyList<std::shared_ptr<OrderBook>> book_storage_;
+    std::atomic<size_t> book_count_ { 0 };
+
+    Shard& shard_for(uint32_t instrument_id) const { return shards_[instrument_id & shard_mask_]; }
+
+    // Shared body of apply_events/apply_records: get(i) returns the i-th
+    // event (or nullptr to skip it), apply(book, event) applies it
+    template <typename Get, typename Apply>
+    size_t apply_batch(size_t count, Get get, Apply apply);
 
-    // Instrument and order book storage
-    std::unordered_map<uint32_t, std::shared_ptr<Instrument>> instruments_;
-    std::unordered_map<uint32_t, std::shared_ptr<OrderBook>> order_books_;
+    // Book for a registered instrument, nullptr if it has none
+    OrderBook* find_book(uint32_t instrument_id) const
+    {
+        const InstrumentSlot* slot = slot_index_.find(instrument_id);
+        if (!slot) {
+            return nullptr;
+        }
+        const std::shared_ptr<OrderBook>* book = slot->book.load(std::memory_order_acquire);
+        return book ? book->get() : nullptr;
+    }
 
     // Helper to ensure instrument exists before creating book
     bool validate_instrument(uint32_t instrument_id) const;
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "market_events.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace market_core {
+
+// Open-addressing map from 64-bit keys to 32-bit slot indices.
+// Linear probing with backward-shift deletion, so there are no tombstones
+// and lookups stay short under heavy add/cancel churn.
+class SlotIndexMap {
+public:
+    static constexpr uint32_t npos = UINT32_MAX;
+
+    explicit SlotIndexMap(size_t initial_capacity = 1024);
+
+    uint32_t find(uint64_t key) const;
+    void insert(uint64_t key, uint32_t value); // Key must not be present
+    void erase(uint64_t key);
+    void clear();
+    size_t size() const { return size_; }
+
+private:
+    static constexpr uint64_t EMPTY_KEY = UINT64_MAX;
+
+    struct Entry {
+        uint64_t key;
+        uint32_t value;
+    };
+
+    std::vector<Entry> entries_;
+    size_t mask_;
+    size_t size_;
+
+    size_t home(uint64_t key) const { return static_cast<size_t>((key * 0x9E3779B97F4A7C15ull) >> 32) & mask_; }
+    void grow();
+};
+
+// Resting order in an order-by-order book
+struct Order {
+    uint64_t order_id;
+    Side side;
+    double price;
+    uint64_t quantity;
+    uint64_t timestamp_ns;
+};
+
+// Order-by-order (L3) storage.
+//
+// Orders live in a pooled node array and are found by ID through a hash
+// index. Each price level is an intrusive FIFO list threaded through the
+// nodes, so add, modify and cancel are O(1) and queue priority is exact.
+// Every operation reports the resulting aggregate level so the owning
+// OrderBook can keep its price-level view up to date incrementally.
+class OrderLevelBook {
+public:
+    // Aggregate state of one level after an order operation; order_count 0 = level gone
+    struct LevelChange {
+        Side side;
+        double price;
+        uint64_t quantity;
+        uint32_t order_count;
+        uint64_t timestamp_ns;
+    };
+
+    OrderLevelBook(double tick_size, size_t initial_orders = 1024);
+
+    // Returns false for a duplicate order ID
+    bool add(uint64_t order_id, Side side, double price, uint64_t quantity, uint64_t timestamp_ns,
+        LevelChange& change);
+
+    // Size reductions keep queue priority; a price change or size increase
+    // requeues the order at the back. May touch two levels (old and new price).
+    // Returns the number of level changes written (0 when the order is unknown).
+    size_t modify(uint64_t order_id, double price, uint64_t quantity, uint64_t timestamp_ns,
+        LevelChange changes[2]);
+
+    // Returns false when the order is unknown
+    bool cancel(uint64_t order_id, LevelChange& change);
+
+    void clear_side(Side side);
+    void clear();
+
+    // Lookups
+    const Order* find(uint64_t order_id) const;
+    size_t queue_position(uint64_t order_id) const; // 1-based within its level, 0 if unknown
+    uint64_t front_order_id(Side side, double price) const; // 0 if the level is empty
+    size_t order_count() const { return order_index_.size(); }
+
+    // Visit the orders resting at a price in time priority
+    template <typename Fn>
+    void for_each_order(Side side, double price, Fn&& fn) const
+    {
+        uint32_t level = level_index_.find(level_key(side, price));
+        if (level == SlotIndexMap::npos) {
+            return;
+        }
+        for (uint32_t node = levels_[level].head; node != NIL; node = nodes_[node].next) {
+            fn(nodes_[node].order);
+        }
+    }
+
+private:
+    static constexpr uint32_t NIL = UINT32_MAX;
+
+    struct OrderNode {
+        Order order;
+        uint32_t prev;
+        uint32_t next; // Also links the free list
+        uint32_t level;
+    };
+
+    struct LevelQueue {
+        uint32_t head;
+        uint32_t tail;
+        uint32_t order_count;
+        uint64_t quantity;
+        double price; // Price of the order that opened the level
+        uint64_t key;
+        uint32_t next_free;
+    };
+
+    double tick_size_;
+    std::vector<OrderNode> nodes_;
+    std::vector<LevelQueue> levels_;
+    uint32_t free_node_;
+    uint32_t free_level_;
+    SlotIndexMap order_index_; // Order ID -> node
+    SlotIndexMap level_index_; // (price tick, side) -> level
+
+    uint64_t level_key(Side side, double price) const;
+    uint32_t acquire_node();
+    void link_back(uint32_t node);
+    void unlink(uint32_t node);
+    void release_node(uint32_t node);
+    LevelChange describe(uint32_t level, Side side, uint64_t timestamp_ns) const;
+};
+
+} // namespace market_core
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace market_core {
+
+// Philox4x32-10 counter-based generator (Salmon et al., "Parallel random
+// numbers: as easy as 1, 2, 3"). Output is a pure function of (counter,
+// key), so any block of any stream can be computed without the ones
+// before it.
+struct Philox4x32 {
+    using Counter = std::array<uint32_t, 4>;
+    using Key = std::array<uint32_t, 2>;
+
+    static Counter generate(Counter counter, Key key)
+    {
+        for (int round = 0; round < 10; ++round) {
+            uint64_t product0 = uint64_t(0xD2511F53) * counter[0];
+            uint64_t product1 = uint64_t(0xCD9E8D57) * counter[2];
+            counter = { static_cast<uint32_t>(product1 >> 32) ^ counter[1] ^ key[0],
+                static_cast<uint32_t>(product1),
+                static_cast<uint32_t>(product0 >> 32) ^ counter[3] ^ key[1],
+                static_cast<uint32_t>(product0) };
+            key[0] += 0x9E3779B9;
+            key[1] += 0xBB67AE85;
+        }
+        return counter;
+    }
+};
+
+// Stream of random numbers identified by (seed, stream, index), e.g.
+// (run seed, instrument ID, update number). Two streams with the same
+// identity produce the same numbers on any thread or machine.
+class CounterRng {
+public:
+    CounterRng() = default;
+    CounterRng(uint64_t seed, uint32_t stream, uint64_t index)
+        : key_ { static_cast<uint32_t>(seed), static_cast<uint32_t>(seed >> 32) }
+        , counter_ { static_cast<uint32_t>(index), static_cast<uint32_t>(index >> 32), stream, 0 }
+    {
+    }
+
+    uint32_t next_u32()
+    {
+        if (used_ == 4) {
+            block_ = Philox4x32::generate(counter_, key_);
+            ++counter_[3];
+            used_ = 0;
+        }
+        return block_[used_++];
+    }
+
+    // [0, 1) with 53 random bits
+    double uniform()
+    {
+        // Separate statements: the draw order must not be left to the compiler
+        uint32_t hi = next_u32();
+        uint32_t lo = next_u32();
+        uint64_t bits = (uint64_t(hi) << 21) ^ (lo >> 11);
+        return static_cast<double>(bits) * (1.0 / 9007199254740992.0);
+    }
+
+    // Standard normal via Box-Muller; the second variate is kept for the next call
+    double normal()
+    {
+        if (has_spare_) {
+            has_spare_ = false;
+            return spare_;
+        }
+        double radius = std::sqrt(-2.0 * std::log(1.0 - uniform()));
+        double angle = 6.283185307179586 * uniform();
+        spare_ = radius * std::sin(angle);
+        has_spare_ = true;
+        return radius * std::cos(angle);
+    }
+
+    // Knuth's method; fine for the small means used for order sizes
+    uint32_t poisson(double mean)
+    {
+        double limit = std::exp(-mean);
+        double product = uniform();
+        uint32_t count = 0;
+        while (product > limit) {
+            product *= uniform();
+            ++count;
+        }
+        return count;
+    }
+
+private:
+    Philox4x32::Key key_ {};
+    Philox4x32::Counter counter_ {};
+    Philox4x32::Counter block_ {};
+    uint32_t used_ = 4;
+    double spare_ = 0.0;
+    bool has_spare_ = false;
+};
+
+} // namespace market_core
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "market_events.h"
+#include "occupancy_bitmap.h"
+#include "price_level.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace market_core {
+
+// One side of a book stored as a contiguous, tick-indexed array of levels.
+//
+// Prices are converted once to integer ticks (price / tick_size) and used
+// directly as array offsets from base_tick_, so an update is an index
+// computation instead of a tree walk. The window is a fixed number of ticks
+// wide and re-centres on the best price when the market drifts outside it;
+// levels that fall off the deep end of the window are dropped. An occupancy
+// bitmap tracks which ticks hold a level, so finding the next best after a
+// delete skips empty ticks a word at a time.
+class PriceLadder {
+public:
+    PriceLadder(Side side, double tick_size, size_t window_ticks);
+
+    // Level operations
+    void set(const PriceLevel& level); // Insert or replace the level at level.price
+    void erase(double price);
+    void clear();
+
+    // Best level, or nullptr when the side is empty
+    const PriceLevel* best() const
+    {
+        return best_index_ < 0 ? nullptr : &slots_[static_cast<size_t>(best_index_)];
+    }
+
+    // Visit up to max_levels levels from best to worst
+    template <typename Fn>
+    void for_each(size_t max_levels, Fn&& fn) const
+    {
+        if (best_index_ < 0) {
+            return;
+        }
+
+        size_t index = static_cast<size_t>(best_index_);
+        for (size_t visited = 0; visited < max_levels; ++visited) {
+            fn(slots_[index]);
+            if (side_ == Side::BID) {
+                index = (index == 0) ? OccupancyBitmap::npos : occupied_.find_prev(index - 1);
+            } else {
+                index = occupied_.find_next(index + 1);
+            }
+            if (index == OccupancyBitmap::npos) {
+                break;
+            }
+        }
+    }
+
+    // State queries
+    size_t size() const { return count_; }
+    bool empty() const { return count_ == 0; }
+    double tick_size() const { return tick_size_; }
+    size_t window_ticks() const { return slots_.size(); }
+    uint64_t dropped_levels() const { return dropped_levels_; }
+
+private:
+    Side side_;
+    double tick_size_;
+    int64_t base_tick_; // Tick held by slots_[0]
+    std::vector<PriceLevel> slots_;
+    OccupancyBitmap occupied_;
+    size_t count_;
+    int64_t best_index_; // -1 when empty
+    uint64_t dropped_levels_;
+
+    // Helper methods
+    int64_t to_tick(double price) const;
+    bool is_better(int64_t index, int64_t other) const;
+    void recentre(int64_t tick);
+    void find_best_from(int64_t index);
+};
+
+} // namespace market_core
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "contributor_registry.h"
+#include <cstdint>
+#include <type_traits>
+
+namespace market_core {
+
+// Price level in the order book.
+//
+// Only the fields touched on every update and snapshot live here, so two
+// levels share a cache line and copying a side is a plain memcpy. Rarely
+// used protocol data (implied quantity) is kept by the book separately.
+struct PriceLevel {
+    double price;
+    uint64_t quantity;
+    uint64_t last_update_time;
+    uint32_t order_count;
+    ContributorId contributor_id; // Interned Reuters contributor, 0 = none
+    uint8_t level_number; // Explicit level number for some protocols, 0 = not set
+};
+
+static_assert(sizeof(PriceLevel) == 32, "PriceLevel should stay half a cache line");
+static_assert(std::is_trivially_copyable<PriceLevel>::value, "PriceLevel must stay trivially copyable");
+
+} // namespace market_core
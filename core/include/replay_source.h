@@ -0,0 +1,79 @@
+#pragma once
+
+#include "event_capture.h"
+#include "order_book_manager.h"
+#include "tsc_clock.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace market_core {
+
+// Event source that plays a capture file back through the same path as
+// MarketDataGenerator: each record is applied to the books and then handed
+// to the listeners, with the recorded timestamps and sequence numbers.
+//
+// Pacing follows the recorded timestamps: speed 1 reproduces the original
+// gaps, speed N divides them by N, and speed 0 sends as fast as possible in
+// blocks of up to BLOCK_RECORDS. Like LoadGenerator, the schedule is fixed
+// at start(), so a slow consumer builds up lag rather than stretching the
+// run. Records are read in place from the mapping and nothing is allocated
+// per event.
+class ReplaySource {
+public:
+    static constexpr size_t BLOCK_RECORDS = 256;
+
+    struct Report {
+        uint64_t replayed = 0;
+        uint64_t total = 0;
+        double elapsed_seconds = 0.0;
+        double achieved_rate = 0.0; // Records per second
+        double recorded_seconds = 0.0; // Span of the capture's timestamps
+        double mean_lag_ns = 0.0; // Send time minus scheduled time
+        double max_lag_ns = 0.0;
+    };
+
+    ReplaySource(std::shared_ptr<OrderBookManager> book_manager, double speed);
+
+    bool open(const std::string& path, std::string& error);
+
+    // Listeners are fixed before the replay starts
+    void add_listener(std::shared_ptr<IMarketEventListener> listener) { listeners_.push_back(std::move(listener)); }
+
+    // Start the schedule now; called by the first run_until if needed
+    void start();
+
+    // Send every record due before deadline (a TscClock tick). Returns the
+    // number sent.
+    size_t run_until(uint64_t deadline);
+    size_t run_for_ns(uint64_t ns) { return run_until(TscClock::now() + TscClock::from_ns(static_cast<double>(ns))); }
+
+    bool finished() const { return next_ == capture_.size(); }
+    double speed() const { return speed_; }
+    size_t size() const { return capture_.size(); }
+    Report report() const;
+
+    // "max" or "0" = as fast as possible, otherwise a positive multiplier
+    static bool parse_speed(const std::string& text, double& speed);
+
+private:
+    std::shared_ptr<OrderBookManager> book_manager_;
+    double speed_;
+    CaptureFile capture_;
+    std::vector<std::shared_ptr<IMarketEventListener>> listeners_;
+
+    bool started_ = false;
+    uint64_t start_ticks_ = 0;
+    uint64_t last_ticks_ = 0;
+    uint64_t first_timestamp_ns_ = 0;
+    double ticks_per_record_ns_ = 0.0; // TSC ticks per recorded nanosecond at this speed
+    size_t next_ = 0;
+
+    double lag_sum_ticks_ = 0.0;
+    uint64_t max_lag_ticks_ = 0;
+
+    void send(const MarketEventRecord* records, size_t count);
+};
+
+} // namespace market_core
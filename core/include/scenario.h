@@ -0,0 +1,100 @@
+#pragma once
+
+#include "latency_histogram.h"
+#include "load_generator.h"
+#include "market_data_generator.h"
+#include "tsc_clock.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace market_core {
+
+// One step of a scenario timeline
+struct ScenarioPhase {
+    MarketMode mode = MarketMode::NORMAL;
+    uint64_t duration_ns = 0;
+    std::string group; // Empty = every instrument
+};
+
+// Parse a timeline such as "NORMAL 60s, STRESSED 5s on channel 2, THIN 30s".
+// Durations take ms, s or m; "on <group>" limits a phase to a named
+// instrument group ("on all" is the same as no group). Returns false with a
+// reason in error.
+bool parse_scenario(const std::string& text, std::vector<ScenarioPhase>& phases, std::string& error);
+
+// Steps MarketDataGenerator through a scenario timeline and measures every
+// phase.
+//
+// A phase without a group sets the global mode and clears per-instrument
+// modes; a phase on a group leaves everyone else on the last global mode.
+// With a LoadGenerator attached, the offered rate follows the modes'
+// updates_per_second relative to NORMAL (weighted by instrument count for a
+// group phase), and each phase reports lag and service-time percentiles
+// taken from the load generator's histograms.
+class ScenarioRunner {
+public:
+    using Groups = std::map<std::string, std::vector<uint32_t>>;
+
+    struct PhaseReport {
+        ScenarioPhase phase;
+        double elapsed_seconds = 0.0;
+        double rate_scale = 1.0; // Applied to the load profile
+        uint64_t updates = 0; // Generator updates during the phase
+        uint64_t trades = 0;
+        double update_rate = 0.0;
+        double target_rate = 0.0; // Load mode only
+        LatencyHistogram lag_ns; // Load mode only
+        LatencyHistogram service_ns; // Load mode only
+    };
+
+    ScenarioRunner(MarketDataGenerator& generator, std::vector<ScenarioPhase> phases, Groups groups,
+        LoadGenerator* load = nullptr);
+
+    // Every group named by a phase must exist; false with the name in error
+    bool validate(std::string& error) const;
+
+    // Enter the first phase now; called by the first update if needed
+    void start();
+
+    // Move on to the phase due at now (a TscClock tick). Returns false once
+    // the timeline is over.
+    bool update(uint64_t now = TscClock::now());
+
+    // Close the phase in progress early, e.g. on shutdown
+    void stop();
+
+    bool finished() const { return current_ >= phases_.size(); }
+    size_t current_phase() const { return current_; }
+    const std::vector<ScenarioPhase>& phases() const { return phases_; }
+    const std::vector<PhaseReport>& reports() const { return reports_; } // Completed phases
+
+    static std::string describe(const ScenarioPhase& phase);
+
+private:
+    MarketDataGenerator& generator_;
+    std::vector<ScenarioPhase> phases_;
+    Groups groups_;
+    LoadGenerator* load_;
+    size_t instrument_count_;
+
+    bool started_ = false;
+    size_t current_ = 0;
+    MarketMode global_mode_ = MarketMode::NORMAL;
+    uint64_t phase_start_ticks_ = 0;
+    uint64_t phase_end_ticks_ = 0;
+    double rate_scale_ = 1.0;
+
+    // Checkpoints at the start of the phase in progress
+    MarketDataGenerator::Statistics stats_start_;
+    LatencyHistogram lag_start_;
+    LatencyHistogram service_start_;
+
+    std::vector<PhaseReport> reports_;
+
+    void enter_phase(uint64_t now);
+    void close_phase(uint64_t now);
+};
+
+} // namespace market_core
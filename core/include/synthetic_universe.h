@@ -0,0 +1,26 @@
+#pragma once
+
+#include "instrument.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace market_core {
+
+// Recipe for a synthetic instrument universe used to load-test the server
+// with far more instruments than a hand-written config would list.
+struct UniverseSpec {
+    size_t count = 0; // Instruments to create
+    uint32_t first_id = 100000; // IDs are first_id, first_id + 1, ...
+    double fx_spot_share = 0.5; // Fraction that are FX spot
+    double fx_forward_share = 0.2; // Fraction that are FX forwards, the rest futures
+    uint64_t seed = 1; // Drives prices so runs are repeatable
+};
+
+// Build the universe in one pass. Symbols are unique ("EURUSD.17",
+// "EURUSD.1M.17", "ESZ6.17"), tick sizes follow the real product (JPY
+// pairs quote to 0.001, ES to 0.25, ...) and every instrument carries the
+// initial_price and initial_spread properties the generator reads.
+std::vector<std::shared_ptr<Instrument>> generate_universe(const UniverseSpec& spec);
+
+} // namespace market_core
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace market_core {
+
+// Best bid/offer copy handed to readers
+struct TopOfBook {
+    double bid_price = 0.0;
+    uint64_t bid_quantity = 0;
+    uint32_t bid_order_count = 0;
+    double ask_price = 0.0;
+    uint64_t ask_quantity = 0;
+    uint32_t ask_order_count = 0;
+    uint64_t version = 0; // Book version, bumped on every book change
+    bool has_bid = false;
+    bool has_ask = false;
+};
+
+// Cache-line sized BBO record published under a seqlock.
+//
+// A single writer (the thread mutating the book) publishes; any number of
+// readers on other cores copy it out without locking and without ever
+// blocking the writer. Readers retry if they overlap a publish.
+class alignas(64) TopOfBookCache {
+public:
+    void publish(const TopOfBook& tob)
+    {
+        uint64_t seq = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        bid_price_.store(tob.bid_price, std::memory_order_relaxed);
+        bid_quantity_.store(tob.bid_quantity, std::memory_order_relaxed);
+        ask_price_.store(tob.ask_price, std::memory_order_relaxed);
+        ask_quantity_.store(tob.ask_quantity, std::memory_order_relaxed);
+        version_.store(tob.version, std::memory_order_relaxed);
+        bid_order_count_.store(tob.bid_order_count, std::memory_order_relaxed);
+        ask_order_count_.store(tob.ask_order_count, std::memory_order_relaxed);
+        flags_.store((tob.has_bid ? BID_FLAG : 0) | (tob.has_ask ? ASK_FLAG : 0), std::memory_order_relaxed);
+
+        sequence_.store(seq + 2, std::memory_order_release);
+    }
+
+    TopOfBook read() const
+    {
+        TopOfBook tob;
+        for (;;) {
+            uint64_t begin = sequence_.load(std::memory_order_acquire);
+            if (begin & 1) {
+                continue; // Publish in progress
+            }
+
+            tob.bid_price = bid_price_.load(std::memory_order_relaxed);
+            tob.bid_quantity = bid_quantity_.load(std::memory_order_relaxed);
+            tob.ask_price = ask_price_.load(std::memory_order_relaxed);
+            tob.ask_quantity = ask_quantity_.load(std::memory_order_relaxed);
+            tob.version = version_.load(std::memory_order_relaxed);
+            tob.bid_order_count = bid_order_count_.load(std::memory_order_relaxed);
+            tob.ask_order_count = ask_order_count_.load(std::memory_order_relaxed);
+            uint32_t flags = flags_.load(std::memory_order_relaxed);
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == begin) {
+                tob.has_bid = flags & BID_FLAG;
+                tob.has_ask = flags & ASK_FLAG;
+                return tob;
+            }
+        }
+    }
+
+private:
+    static constexpr uint32_t BID_FLAG = 0x01;
+    static constexpr uint32_t ASK_FLAG = 0x02;
+
+    std::atomic<uint64_t> sequence_ { 0 }; // Odd while a publish is in progress
+    std::atomic<double> bid_price_ { 0.0 };
+    std::atomic<uint64_t> bid_quantity_ { 0 };
+    std::atomic<double> ask_price_ { 0.0 };
+    std::atomic<uint64_t> ask_quantity_ { 0 };
+    std::atomic<uint64_t> version_ { 0 };
+    std::atomic<uint32_t> bid_order_count_ { 0 };
+    std::atomic<uint32_t> ask_order_count_ { 0 };
+    std::atomic<uint32_t> flags_ { 0 };
+};
+
+static_assert(sizeof(TopOfBookCache) == 64, "TopOfBookCache must fit one cache line");
+
+} // namespace market_core
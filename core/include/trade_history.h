@@ -0,0 +1,157 @@
+#pragma once
+
+#include "market_events.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace market_core {
+
+// Trade information
+struct Trade {
+    double price;
+    uint64_t quantity;
+    uint64_t timestamp_ns;
+    std::optional<Side> aggressor_side;
+    uint64_t trade_number = 0; // Numeric trade ID, 0 = none; recording it never allocates
+    std::optional<std::string> trade_id; // Textual ID from the event path
+
+    // The trade ID as text; a numeric one is formatted here, not when recorded
+    std::optional<std::string> id() const
+    {
+        if (trade_id) {
+            return trade_id;
+        }
+        if (trade_number != 0) {
+            return std::to_string(trade_number);
+        }
+        return std::nullopt;
+    }
+};
+
+// Non-owning view of recent trades, oldest first.
+//
+// The trades live in a ring buffer, so the view is at most two contiguous
+// runs: first_run() followed by second_run(). It is invalidated by the next
+// trade added to the owning book.
+class TradeHistoryView {
+public:
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = Trade;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const Trade*;
+        using reference = const Trade&;
+
+        const_iterator(const TradeHistoryView* view, size_t index)
+            : view_(view)
+            , index_(index)
+        {
+        }
+
+        reference operator*() const { return (*view_)[index_]; }
+        pointer operator->() const { return &(*view_)[index_]; }
+        const_iterator& operator++()
+        {
+            ++index_;
+            return *this;
+        }
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const TradeHistoryView* view_;
+        size_t index_;
+    };
+
+    TradeHistoryView() = default;
+    TradeHistoryView(const Trade* first, size_t first_size, const Trade* second, size_t second_size)
+        : first_(first)
+        , first_size_(first_size)
+        , second_(second)
+        , second_size_(second_size)
+    {
+    }
+
+    size_t size() const { return first_size_ + second_size_; }
+    bool empty() const { return size() == 0; }
+
+    const Trade& operator[](size_t index) const
+    {
+        return index < first_size_ ? first_[index] : second_[index - first_size_];
+    }
+    const Trade& front() const { return (*this)[0]; }
+    const Trade& back() const { return (*this)[size() - 1]; }
+
+    // The two contiguous runs, oldest first
+    std::pair<const Trade*, size_t> first_run() const { return { first_, first_size_ }; }
+    std::pair<const Trade*, size_t> second_run() const { return { second_, second_size_ }; }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, size()); }
+
+private:
+    const Trade* first_ = nullptr;
+    size_t first_size_ = 0;
+    const Trade* second_ = nullptr;
+    size_t second_size_ = 0;
+};
+
+// Fixed-capacity trade history. Slots are allocated once and overwritten in
+// place, so recording a trade is O(1) and does not shift older trades.
+class TradeRing {
+public:
+    explicit TradeRing(size_t capacity)
+        : slots_(capacity > 0 ? capacity : 1)
+        , next_(0)
+        , size_(0)
+    {
+    }
+
+    void push(const Trade& trade)
+    {
+        slots_[next_] = trade;
+        next_ = (next_ + 1 == slots_.size()) ? 0 : next_ + 1;
+        if (size_ < slots_.size()) {
+            ++size_;
+        }
+    }
+
+    void clear()
+    {
+        next_ = 0;
+        size_ = 0;
+    }
+
+    size_t size() const { return size_; }
+    size_t capacity() const { return slots_.size(); }
+
+    // View of the newest count trades, oldest first
+    TradeHistoryView latest(size_t count) const
+    {
+        count = std::min(count, size_);
+        if (count == 0) {
+            return TradeHistoryView();
+        }
+
+        size_t start = (next_ + slots_.size() - count) % slots_.size();
+        if (start + count <= slots_.size()) {
+            return TradeHistoryView(&slots_[start], count, nullptr, 0);
+        }
+
+        size_t first_size = slots_.size() - start;
+        return TradeHistoryView(&slots_[start], first_size, &slots_[0], count - first_size);
+    }
+
+private:
+    std::vector<Trade> slots_;
+    size_t next_; // Slot the next trade is written to
+    size_t size_;
+};
+
+} // namespace market_core
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define MARKET_CORE_HAS_TSC 1
+#endif
+
+namespace market_core {
+
+// Cycle counter for pacing loops.
+//
+// On x86 this reads the TSC (assumed invariant, as on any recent server
+// CPU) and is calibrated once against steady_clock; elsewhere it falls
+// back to steady_clock nanoseconds. Ticks are only meaningful relative to
+// each other on the same machine.
+class TscClock {
+public:
+    static uint64_t now()
+    {
+#ifdef MARKET_CORE_HAS_TSC
+        return __rdtsc();
+#else
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+                                         .count());
+#endif
+    }
+
+    static double ticks_per_ns()
+    {
+        static const double value = calibrate();
+        return value;
+    }
+
+    static uint64_t from_ns(double ns) { return static_cast<uint64_t>(ns * ticks_per_ns()); }
+    static double to_ns(uint64_t ticks) { return static_cast<double>(ticks) / ticks_per_ns(); }
+
+    // Spin-wait hint
+    static void pause()
+    {
+#ifdef MARKET_CORE_HAS_TSC
+        _mm_pause();
+#endif
+    }
+
+private:
+    static double calibrate()
+    {
+#ifdef MARKET_CORE_HAS_TSC
+        auto start_time = std::chrono::steady_clock::now();
+        uint64_t start_ticks = __rdtsc();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        uint64_t end_ticks = __rdtsc();
+        auto end_time = std::chrono::steady_clock::now();
+
+        double ns = static_cast<double>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+        return ns > 0 ? static_cast<double>(end_ticks - start_ticks) / ns : 1.0;
+#else
+        return 1.0;
+#endif
+    }
+};
+
+} // namespace market_core
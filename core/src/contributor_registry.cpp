@@ -0,0 +1,49 @@
+#include "../include/contributor_registry.h"
+#include <limits>
+
+namespace market_core {
+
+ContributorRegistry& ContributorRegistry::instance()
+{
+    static ContributorRegistry registry;
+    return registry;
+}
+
+ContributorId ContributorRegistry::intern(const std::string& name)
+{
+    if (name.empty()) {
+        return NO_CONTRIBUTOR;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        return it->second;
+    }
+
+    if (names_.size() >= std::numeric_limits<ContributorId>::max()) {
+        return NO_CONTRIBUTOR;
+    }
+
+    names_.push_back(name);
+    auto id = static_cast<ContributorId>(names_.size());
+    ids_.emplace(name, id);
+    return id;
+}
+
+std::string ContributorRegistry::name(ContributorId id) const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (id == NO_CONTRIBUTOR || id > names_.size()) {
+        return std::string();
+    }
+    return names_[id - 1];
+}
+
+size_t ContributorRegistry::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return names_.size();
+}
+
+} // namespace market_core
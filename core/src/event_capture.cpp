@@ -0,0 +1,156 @@
+#include "../include/event_capture.h"
+#include <cstring>
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace market_core {
+
+static constexpr char CAPTURE_MAGIC[8] = { 'R', 'S', 'B', 'E', 'C', 'A', 'P', '1' };
+static constexpr uint32_t CAPTURE_VERSION = 1;
+static constexpr size_t CAPTURE_BUFFER_RECORDS = 4096;
+
+static CaptureHeader make_header(uint64_t record_count)
+{
+    CaptureHeader header {};
+    std::memcpy(header.magic, CAPTURE_MAGIC, sizeof(header.magic));
+    header.version = CAPTURE_VERSION;
+    header.record_size = sizeof(MarketEventRecord);
+    header.record_count = record_count;
+    return header;
+}
+
+CaptureWriter::~CaptureWriter()
+{
+    close();
+}
+
+bool CaptureWriter::open(const std::string& path)
+{
+    close();
+    file_ = std::fopen(path.c_str(), "wb");
+    if (!file_) {
+        return false;
+    }
+    CaptureHeader header = make_header(0);
+    if (std::fwrite(&header, sizeof(header), 1, file_) != 1) {
+        std::fclose(file_);
+        file_ = nullptr;
+        return false;
+    }
+    buffer_.reserve(CAPTURE_BUFFER_RECORDS);
+    records_written_ = 0;
+    return true;
+}
+
+void CaptureWriter::write(const MarketEventRecord* records, size_t count)
+{
+    if (!file_) {
+        return;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        buffer_.push_back(records[i]);
+        if (buffer_.size() == CAPTURE_BUFFER_RECORDS) {
+            flush();
+        }
+    }
+}
+
+void CaptureWriter::on_market_event(const std::shared_ptr<MarketEvent>& event)
+{
+    MarketEventRecord record;
+    if (event && to_record(*event, record)) {
+        write(&record, 1);
+    }
+}
+
+void CaptureWriter::flush()
+{
+    if (!buffer_.empty()) {
+        records_written_ += std::fwrite(buffer_.data(), sizeof(MarketEventRecord), buffer_.size(), file_);
+        buffer_.clear();
+    }
+}
+
+void CaptureWriter::close()
+{
+    if (!file_) {
+        return;
+    }
+    flush();
+
+    // Finalise the count so readers ignore any torn tail
+    CaptureHeader header = make_header(records_written_);
+    std::fseek(file_, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, file_);
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+CaptureFile::~CaptureFile()
+{
+    close();
+}
+
+bool CaptureFile::open(const std::string& path, std::string& error)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        error = "cannot open " + path + ": " + std::strerror(errno);
+        return false;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(CaptureHeader)) {
+        error = path + " is not a capture file";
+        ::close(fd);
+        return false;
+    }
+
+    auto size = static_cast<size_t>(info.st_size);
+    void* mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // The mapping keeps the file alive
+    if (mapping == MAP_FAILED) {
+        error = "cannot map " + path + ": " + std::strerror(errno);
+        return false;
+    }
+
+    const auto* header = static_cast<const CaptureHeader*>(mapping);
+    if (std::memcmp(header->magic, CAPTURE_MAGIC, sizeof(CAPTURE_MAGIC)) != 0 || header->version != CAPTURE_VERSION) {
+        error = path + " is not a capture file";
+        ::munmap(mapping, size);
+        return false;
+    }
+    if (header->record_size != sizeof(MarketEventRecord)) {
+        error = path + " was recorded with a different record layout";
+        ::munmap(mapping, size);
+        return false;
+    }
+
+    size_t available = (size - sizeof(CaptureHeader)) / sizeof(MarketEventRecord);
+    mapping_ = mapping;
+    mapping_size_ = size;
+    records_ = reinterpret_cast<const MarketEventRecord*>(static_cast<const char*>(mapping) + sizeof(CaptureHeader));
+    count_ = header->record_count > 0 && header->record_count < available ? header->record_count : available;
+
+    // Replay reads front to back once
+    ::madvise(mapping, size, MADV_SEQUENTIAL);
+    ::madvise(mapping, size, MADV_WILLNEED);
+    return true;
+}
+
+void CaptureFile::close()
+{
+    if (mapping_) {
+        ::munmap(mapping_, mapping_size_);
+    }
+    mapping_ = nullptr;
+    mapping_size_ = 0;
+    records_ = nullptr;
+    count_ = 0;
+}
+
+} // namespace market_core
@@ -0,0 +1,91 @@
+#include "../include/hawkes_arrivals.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace market_core {
+
+// Arrivals produced per window on average
+static constexpr double WINDOW_EVENTS = 1024.0;
+
+HawkesArrivals::HawkesArrivals(const HawkesParameters& parameters, double mean_rate,
+    std::vector<uint32_t> instrument_ids, uint64_t seed)
+    : parameters_(parameters)
+    , mean_rate_(mean_rate)
+    , instrument_ids_(std::move(instrument_ids))
+    , rng_(seed, UINT32_MAX - 1, 0) // Stream apart from the per-instrument update streams
+{
+    parameters_.self_excitation = std::max(0.0, parameters_.self_excitation);
+    parameters_.cross_excitation = std::max(0.0, parameters_.cross_excitation);
+    parameters_.decay_per_second = std::max(1e-9, parameters_.decay_per_second);
+    double ratio = parameters_.branching_ratio();
+    if (ratio > MAX_BRANCHING_RATIO) {
+        parameters_.self_excitation *= MAX_BRANCHING_RATIO / ratio;
+        parameters_.cross_excitation *= MAX_BRANCHING_RATIO / ratio;
+        ratio = MAX_BRANCHING_RATIO;
+    }
+
+    // Children make up the rest of the long-run rate
+    background_rate_ = mean_rate_ * (1.0 - ratio);
+    window_ns_ = mean_rate_ > 0.0 ? WINDOW_EVENTS / mean_rate_ * 1e9 : 1e9;
+    next_background_ns_ = background_rate_ > 0.0 && !instrument_ids_.empty()
+        ? exponential(background_rate_ / 1e9)
+        : std::numeric_limits<double>::infinity();
+}
+
+uint32_t HawkesArrivals::random_index()
+{
+    auto count = static_cast<uint32_t>(instrument_ids_.size());
+    return std::min(count - 1, static_cast<uint32_t>(rng_.uniform() * count));
+}
+
+double HawkesArrivals::exponential(double rate_per_ns)
+{
+    return -std::log(1.0 - rng_.uniform()) / rate_per_ns;
+}
+
+void HawkesArrivals::fill_window()
+{
+    const double window_end = window_start_ns_ + window_ns_;
+    const double decay_per_ns = parameters_.decay_per_second / 1e9;
+    window_.clear();
+    cursor_ = 0;
+
+    // Children from earlier windows that land in this one
+    size_t kept = 0;
+    for (const Pending& event : carried_) {
+        if (event.time_ns < window_end) {
+            work_.push_back(event);
+        } else {
+            carried_[kept++] = event;
+        }
+    }
+    carried_.resize(kept);
+
+    while (next_background_ns_ < window_end) {
+        work_.push_back({ next_background_ns_, random_index() });
+        next_background_ns_ += exponential(background_rate_ / 1e9);
+    }
+
+    // Branch until every descendant inside the window has been emitted;
+    // emission order does not matter because the window is sorted after
+    while (!work_.empty()) {
+        Pending event = work_.back();
+        work_.pop_back();
+        window_.push_back({ static_cast<uint64_t>(event.time_ns), instrument_ids_[event.index] });
+
+        uint32_t self_children = rng_.poisson(parameters_.self_excitation);
+        uint32_t cross_children = rng_.poisson(parameters_.cross_excitation);
+        for (uint32_t i = 0; i < self_children + cross_children; ++i) {
+            Pending child { event.time_ns + exponential(decay_per_ns), i < self_children ? event.index : random_index() };
+            (child.time_ns < window_end ? work_ : carried_).push_back(child);
+        }
+    }
+
+    std::sort(window_.begin(), window_.end(), [](const Arrival& a, const Arrival& b) {
+        return a.time_ns < b.time_ns;
+    });
+    window_start_ns_ = window_end;
+}
+
+} // namespace market_core
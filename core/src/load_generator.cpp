@@ -0,0 +1,220 @@
+#include "../include/load_generator.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace market_core {
+
+static double peak_rate_of(const LoadGenerator::Profile& profile)
+{
+    return profile.peak_rate > 0.0 ? profile.peak_rate : 4.0 * profile.rate;
+}
+
+double LoadGenerator::Profile::mean_rate() const
+{
+    if (shape == Shape::SQUARE_WAVE) {
+        return duty_cycle * peak_rate_of(*this) + (1.0 - duty_cycle) * rate;
+    }
+    return rate;
+}
+
+LoadGenerator::LoadGenerator(MarketDataGenerator& generator, std::vector<uint32_t> instrument_ids, const Profile& profile)
+    : generator_(generator)
+    , instrument_ids_(std::move(instrument_ids))
+    , profile_(profile)
+    , rng_(profile.seed)
+{
+    profile_.burst_size = std::max<uint32_t>(1, profile_.burst_size);
+    profile_.duty_cycle = std::min(1.0, std::max(0.0, profile_.duty_cycle));
+}
+
+void LoadGenerator::start()
+{
+    started_ = true;
+    start_ticks_ = TscClock::now();
+    last_ticks_ = start_ticks_;
+    scale_since_ticks_ = start_ticks_;
+    schedule_base_ = 0.0;
+    ns_per_tick_ = 1.0 / TscClock::ticks_per_ns();
+    // A square wave with an idle base rate still sends from its first peak
+    next_due_ = profile_.mean_rate() > 0.0 ? 0.0 : std::numeric_limits<double>::infinity();
+    burst_remaining_ = profile_.burst_size - 1; // First burst starts immediately
+    if (profile_.shape == Profile::Shape::HAWKES && profile_.rate > 0.0 && !instrument_ids_.empty()) {
+        // Arrival times are fixed up front; the loop only replays them
+        arrivals_ = std::make_unique<HawkesArrivals>(
+            generator_.get_config().hawkes, profile_.rate, instrument_ids_, profile_.seed);
+        const auto& first = arrivals_->next();
+        next_due_ = static_cast<double>(first.time_ns) * TscClock::ticks_per_ns();
+        next_arrival_instrument_ = first.instrument_id;
+    }
+    sent_ = 0;
+    lag_sum_ticks_ = 0.0;
+    max_lag_ticks_ = 0;
+    lag_ns_.reset();
+    service_ns_.reset();
+}
+
+void LoadGenerator::set_rate_scale(double scale)
+{
+    scale = std::max(0.0, scale);
+    if (started_) {
+        uint64_t now = TscClock::now();
+        schedule_base_ = schedule_elapsed(now);
+        scale_since_ticks_ = now;
+    }
+    rate_scale_ = scale;
+}
+
+size_t LoadGenerator::run_until(uint64_t deadline)
+{
+    if (!started_) {
+        start();
+    }
+    if (instrument_ids_.empty()) {
+        return 0;
+    }
+
+    size_t sent = 0;
+    for (;;) {
+        uint64_t now = TscClock::now();
+        last_ticks_ = now;
+        double elapsed = schedule_elapsed(now);
+
+        if (next_due_ <= elapsed) {
+            // Schedule ticks back to wall ticks
+            auto lag = rate_scale_ > 0.0 ? static_cast<uint64_t>((elapsed - next_due_) / rate_scale_) : 0;
+            lag_sum_ticks_ += static_cast<double>(lag);
+            max_lag_ticks_ = std::max(max_lag_ticks_, lag);
+            lag_ns_.record(static_cast<uint64_t>(static_cast<double>(lag) * ns_per_tick_));
+
+            if (arrivals_) {
+                generator_.generate_update(next_arrival_instrument_);
+            } else {
+                // Round-robin keeps instrument choice off the random number budget
+                generator_.generate_update(instrument_ids_[next_instrument_]);
+                if (++next_instrument_ == instrument_ids_.size()) {
+                    next_instrument_ = 0;
+                }
+            }
+            service_ns_.record(static_cast<uint64_t>(static_cast<double>(TscClock::now() - now) * ns_per_tick_));
+
+            ++sent_;
+            ++sent;
+            advance_schedule();
+
+            // Even when behind, hand control back so the caller can do housekeeping
+            if (now >= deadline) {
+                break;
+            }
+            continue;
+        }
+
+        if (now >= deadline) {
+            break;
+        }
+        TscClock::pause();
+    }
+    return sent;
+}
+
+void LoadGenerator::advance_schedule()
+{
+    const double ticks_per_second = TscClock::ticks_per_ns() * 1e9;
+
+    switch (profile_.shape) {
+    case Profile::Shape::STEADY:
+        next_due_ += ticks_per_second / profile_.rate;
+        break;
+    case Profile::Shape::SQUARE_WAVE: {
+        // Rate follows the phase of the update just scheduled
+        double period = static_cast<double>(std::max<uint64_t>(1, profile_.period_ns));
+        auto rate_at = [&](double due_ticks) {
+            double due_ns = due_ticks / TscClock::ticks_per_ns();
+            return std::fmod(due_ns, period) < profile_.duty_cycle * period ? peak_rate_of(profile_) : profile_.rate;
+        };
+        next_due_ += ticks_per_second / rate_at(next_due_);
+        if (rate_at(next_due_) <= 0.0) {
+            // Nothing is sent off peak at rate 0: resume at the next period
+            double due_ns = next_due_ / TscClock::ticks_per_ns();
+            next_due_ = (std::floor(due_ns / period) + 1.0) * period * TscClock::ticks_per_ns();
+        }
+        break;
+    }
+    case Profile::Shape::POISSON_BURSTS:
+        if (burst_remaining_ > 0) {
+            --burst_remaining_; // Rest of the burst goes out back to back
+        } else {
+            double mean_gap = ticks_per_second * profile_.burst_size / profile_.rate;
+            next_due_ += burst_gap_(rng_) * mean_gap;
+            burst_remaining_ = profile_.burst_size - 1;
+        }
+        break;
+    case Profile::Shape::HAWKES: {
+        const auto& arrival = arrivals_->next();
+        next_due_ = static_cast<double>(arrival.time_ns) * TscClock::ticks_per_ns();
+        next_arrival_instrument_ = arrival.instrument_id;
+        break;
+    }
+    }
+}
+
+LoadGenerator::Report LoadGenerator::report() const
+{
+    Report report;
+    report.sent = sent_;
+    report.target_rate = profile_.mean_rate();
+
+    double elapsed_ticks = static_cast<double>(last_ticks_ - start_ticks_);
+    double schedule_ticks = started_ ? schedule_elapsed(last_ticks_) : 0.0;
+    double elapsed_ns = elapsed_ticks / TscClock::ticks_per_ns();
+    report.elapsed_seconds = elapsed_ns / 1e9;
+    if (report.elapsed_seconds > 0.0) {
+        report.achieved_rate = static_cast<double>(sent_) / report.elapsed_seconds;
+        // Rate scaling changes what was actually asked for
+        report.target_rate *= schedule_ticks / elapsed_ticks;
+    }
+    if (sent_ > 0) {
+        report.mean_lag_ns = TscClock::to_ns(static_cast<uint64_t>(lag_sum_ticks_ / static_cast<double>(sent_)));
+    }
+    report.max_lag_ns = TscClock::to_ns(max_lag_ticks_);
+    report.p99_lag_ns = static_cast<double>(lag_ns_.percentile(0.99));
+    report.p50_service_ns = static_cast<double>(service_ns_.percentile(0.5));
+    report.p99_service_ns = static_cast<double>(service_ns_.percentile(0.99));
+    if (started_ && next_due_ < schedule_ticks && rate_scale_ > 0.0) {
+        report.backlog_ns = (schedule_ticks - next_due_) / rate_scale_ / TscClock::ticks_per_ns();
+    }
+    return report;
+}
+
+bool LoadGenerator::parse_shape(const std::string& name, Profile::Shape& shape)
+{
+    if (name == "steady") {
+        shape = Profile::Shape::STEADY;
+    } else if (name == "square") {
+        shape = Profile::Shape::SQUARE_WAVE;
+    } else if (name == "poisson") {
+        shape = Profile::Shape::POISSON_BURSTS;
+    } else if (name == "hawkes") {
+        shape = Profile::Shape::HAWKES;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* LoadGenerator::shape_name(Profile::Shape shape)
+{
+    switch (shape) {
+    case Profile::Shape::STEADY:
+        return "steady";
+    case Profile::Shape::SQUARE_WAVE:
+        return "square";
+    case Profile::Shape::POISSON_BURSTS:
+        return "poisson";
+    case Profile::Shape::HAWKES:
+        return "hawkes";
+    }
+    return "unknown";
+}
+
+} // namespace market_core
@@ -1,5 +1,8 @@
 #include "../include/market_data_generator.h"
+#include <algorithm>
+#include <cctype>
 #include <chrono>
+#include <cmath>
 #include <random>
 
 namespace market_core {
@@ -10,69 +13,238 @@ MarketDataGenerator::MarketDataGenerator(std::shared_ptr<OrderBookManager> book_
     , rng_(std::chrono::steady_clock::now().time_since_epoch().count())
 {
     stats_.start_time = std::chrono::steady_clock::now();
+    refresh_mode_configs();
 }
 
-void MarketDataGenerator::set_market_mode(MarketMode mode)
+MarketDataGenerator::~MarketDataGenerator()
 {
-    config_.mode = mode;
+    delete listener_snapshot_.load(std::memory_order_relaxed);
+}
+
+void MarketDataGenerator::apply_mode_preset(MarketMode mode, MarketConfig& config)
+{
+    config.mode = mode;
 
     // Set mode-specific parameters
     switch (mode) {
     case MarketMode::NORMAL:
-        config_.volatility = 0.0001; // 0.01%
-        config_.updates_per_second = 10;
-        config_.trade_probability = 0.3;
+        config.volatility = 0.0001; // 0.01%
+        config.updates_per_second = 10;
+        config.trade_probability = 0.3;
+        config.hawkes.self_excitation = 0.5;
+        config.hawkes.cross_excitation = 0.1;
         break;
     case MarketMode::FAST:
-        config_.volatility = 0.0002;
-        config_.updates_per_second = 50;
-        config_.trade_probability = 0.5;
+        config.volatility = 0.0002;
+        config.updates_per_second = 50;
+        config.trade_probability = 0.5;
+        config.hawkes.self_excitation = 0.6;
+        config.hawkes.cross_excitation = 0.1;
         break;
     case MarketMode::VOLATILE:
-        config_.volatility = 0.001; // 0.1%
-        config_.updates_per_second = 20;
-        config_.trade_probability = 0.4;
+        config.volatility = 0.001; // 0.1%
+        config.updates_per_second = 20;
+        config.trade_probability = 0.4;
+        config.hawkes.self_excitation = 0.7;
+        config.hawkes.cross_excitation = 0.15;
         break;
     case MarketMode::THIN:
-        config_.volatility = 0.00005;
-        config_.updates_per_second = 3;
-        config_.trade_probability = 0.1;
-        config_.book_depth_target = 2;
+        config.volatility = 0.00005;
+        config.updates_per_second = 3;
+        config.trade_probability = 0.1;
+        config.book_depth_target = 2;
+        config.hawkes.self_excitation = 0.3;
+        config.hawkes.cross_excitation = 0.05;
         break;
     case MarketMode::TRENDING:
-        config_.volatility = 0.0001;
-        config_.trend_bias = 0.3; // Upward bias
-        config_.updates_per_second = 15;
+        config.volatility = 0.0001;
+        config.trend_bias = 0.3; // Upward bias
+        config.updates_per_second = 15;
+        config.trade_probability = 0.3;
         break;
-    case MarketMode::STRESSED:
-        config_.volatility = 0.002; // 0.2%
-        config_.updates_per_second = 100;
-        config_.trade_probability = 0.7;
-        config_.spread_factor = 3.0;
+    case MarketMode::AUCTION:
+        // Orders build up without matching; the auction prints on exit
+        config.volatility = 0.00005;
+        config.updates_per_second = 5;
+        config.trade_probability = 0.0;
+        config.hawkes.self_excitation = 0.2;
+        config.hawkes.cross_excitation = 0.05;
         break;
-    default:
+    case MarketMode::STRESSED:
+        config.volatility = 0.002; // 0.2%
+        config.updates_per_second = 100;
+        config.trade_probability = 0.7;
+        config.spread_factor = 3.0;
+        // Stress feeds on itself: long, market-wide bursts
+        config.hawkes.self_excitation = 0.8;
+        config.hawkes.cross_excitation = 0.15;
         break;
     }
 }
 
+void MarketDataGenerator::set_market_mode(MarketMode mode)
+{
+    MarketMode previous = config_.mode;
+    apply_mode_preset(mode, config_);
+    batch_arrivals_.reset();
+    refresh_mode_configs();
+
+    if ((previous == MarketMode::AUCTION) != (mode == MarketMode::AUCTION)) {
+        for (uint32_t instrument_id : book_manager_->get_all_instrument_ids()) {
+            if (instrument_modes_.find(instrument_id) == instrument_modes_.end()) {
+                change_mode(instrument_id, previous, mode);
+            }
+        }
+    }
+}
+
+void MarketDataGenerator::refresh_mode_configs()
+{
+    for (size_t i = 0; i < MARKET_MODE_COUNT; ++i) {
+        mode_configs_[i] = config_;
+        apply_mode_preset(static_cast<MarketMode>(i), mode_configs_[i]);
+    }
+}
+
+const MarketConfig& MarketDataGenerator::config_for(uint32_t instrument_id) const
+{
+    if (instrument_modes_.empty()) {
+        return config_;
+    }
+    auto it = instrument_modes_.find(instrument_id);
+    return it == instrument_modes_.end() ? config_ : mode_configs_[static_cast<size_t>(it->second)];
+}
+
+void MarketDataGenerator::set_instrument_mode(const std::vector<uint32_t>& instrument_ids, MarketMode mode)
+{
+    for (uint32_t instrument_id : instrument_ids) {
+        MarketMode previous = get_instrument_mode(instrument_id);
+        instrument_modes_[instrument_id] = mode;
+        change_mode(instrument_id, previous, mode);
+    }
+}
+
+void MarketDataGenerator::clear_instrument_modes()
+{
+    auto modes = std::move(instrument_modes_);
+    instrument_modes_.clear();
+    for (const auto& entry : modes) {
+        change_mode(entry.first, entry.second, config_.mode);
+    }
+}
+
+void MarketDataGenerator::change_mode(uint32_t instrument_id, MarketMode from, MarketMode to)
+{
+    if ((from == MarketMode::AUCTION) == (to == MarketMode::AUCTION)) {
+        return;
+    }
+    BookRef ref = book_manager_->get_book_ref(instrument_id);
+    if (!ref) {
+        return;
+    }
+    uint64_t timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+                                .count();
+
+    if (from == MarketMode::AUCTION) {
+        // Uncross at the mid for what both sides can fill
+        TopOfBook tob = ref.book->read_top_of_book();
+        if (tob.has_bid && tob.has_ask) {
+            MarketEventRecord trade = MarketEventRecord::make_trade(instrument_id);
+            trade.timestamp_ns = timestamp_ns;
+            trade.sequence_number = get_next_sequence(instrument_id);
+            trade.trade.price = apply_tick_rounding((tob.bid_price + tob.ask_price) / 2.0, ref.runtime->tick_size);
+            trade.trade.quantity = std::min(tob.bid_quantity, tob.ask_quantity);
+            trade.trade.aggressor_side = Side::NONE;
+            notify_listeners(trade);
+            stats_.trades_generated++;
+        }
+    }
+
+    MarketEventRecord status = MarketEventRecord::make_status(instrument_id);
+    status.timestamp_ns = timestamp_ns;
+    status.sequence_number = get_next_sequence(instrument_id);
+    status.status.status = to == MarketMode::AUCTION ? StatusEvent::OPENING_AUCTION : StatusEvent::CONTINUOUS_TRADING;
+    notify_listeners(status);
+}
+
+bool MarketDataGenerator::parse_market_mode(const std::string& name, MarketMode& mode)
+{
+    std::string upper = name;
+    std::transform(upper.begin(), upper.end(), upper.begin(), [](unsigned char c) { return std::toupper(c); });
+    for (size_t i = 0; i < MARKET_MODE_COUNT; ++i) {
+        if (upper == market_mode_name(static_cast<MarketMode>(i))) {
+            mode = static_cast<MarketMode>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* MarketDataGenerator::market_mode_name(MarketMode mode)
+{
+    switch (mode) {
+    case MarketMode::NORMAL:
+        return "NORMAL";
+    case MarketMode::FAST:
+        return "FAST";
+    case MarketMode::THIN:
+        return "THIN";
+    case MarketMode::VOLATILE:
+        return "VOLATILE";
+    case MarketMode::TRENDING:
+        return "TRENDING";
+    case MarketMode::AUCTION:
+        return "AUCTION";
+    case MarketMode::STRESSED:
+        return "STRESSED";
+    }
+    return "UNKNOWN";
+}
+
+void MarketDataGenerator::set_seed(uint64_t seed)
+{
+    seeded_ = true;
+    seed_ = seed;
+    update_counts_.clear();
+    batch_count_ = 0;
+    batch_arrivals_.reset();
+}
+
+void MarketDataGenerator::begin_update(uint32_t instrument_id)
+{
+    if (seeded_) {
+        event_rng_ = CounterRng(seed_, instrument_id, update_counts_[instrument_id]++);
+    }
+}
+
+double MarketDataGenerator::next_uniform()
+{
+    return seeded_ ? event_rng_.uniform() : uniform_dist_(rng_);
+}
+
+double MarketDataGenerator::next_normal()
+{
+    return seeded_ ? event_rng_.normal() : normal_dist_(rng_);
+}
+
 void MarketDataGenerator::generate_update(uint32_t instrument_id)
 {
-    auto [instrument, book] = book_manager_->get_instrument_and_book(instrument_id);
-    if (!instrument || !book) {
+    if (!book_manager_->get_book_ref(instrument_id)) {
         return;
     }
+    begin_update(instrument_id);
 
-    // Decide what type of update to generate
-    if (should_generate_trade()) {
-        auto trade_event = generate_trade(instrument_id);
-        if (trade_event) {
-            notify_listeners(trade_event);
+    // Decide what type of update to generate; the record lives on the stack
+    MarketEventRecord record;
+    if (should_generate_trade(config_for(instrument_id))) {
+        if (generate_trade_record(instrument_id, record)) {
+            notify_listeners(record);
             stats_.trades_generated++;
         }
     } else {
-        auto quote_event = generate_quote(instrument_id);
-        if (quote_event) {
-            notify_listeners(quote_event);
+        if (generate_quote_record(instrument_id, record)) {
+            notify_listeners(record);
             stats_.quotes_generated++;
         }
     }
@@ -87,130 +259,311 @@ void MarketDataGenerator::generate_batch(int count)
         return;
     }
 
+    if (config_.hawkes.enabled) {
+        // Clustered picks; timestamps are dropped, only the order is used
+        if (!batch_arrivals_ || batch_arrivals_->instrument_count() != instrument_ids.size()) {
+            double rate = std::max(1, config_.updates_per_second) * static_cast<double>(instrument_ids.size());
+            batch_arrivals_ = std::make_unique<HawkesArrivals>(
+                config_.hawkes, rate, instrument_ids, seeded_ ? seed_ : rng_());
+        }
+        for (int i = 0; i < count; ++i) {
+            generate_update(batch_arrivals_->next().instrument_id);
+        }
+        return;
+    }
+
+    // Seeded runs pick instruments from their own stream, one per batch call
+    CounterRng pick_rng(seed_, UINT32_MAX, batch_count_++);
     for (int i = 0; i < count; ++i) {
         // Pick random instrument
-        std::uniform_int_distribution<> inst_dist(0, instrument_ids.size() - 1);
-        uint32_t instrument_id = instrument_ids[inst_dist(rng_)];
-        generate_update(instrument_id);
+        size_t index;
+        if (seeded_) {
+            index = std::min(instrument_ids.size() - 1, static_cast<size_t>(pick_rng.uniform() * instrument_ids.size()));
+        } else {
+            std::uniform_int_distribution<> inst_dist(0, instrument_ids.size() - 1);
+            index = inst_dist(rng_);
+        }
+        generate_update(instrument_ids[index]);
     }
 }
 
 void MarketDataGenerator::generate_all_instruments()
 {
+    // One block keeps start-up linear in the instrument count
     auto instrument_ids = book_manager_->get_all_instrument_ids();
-    for (uint32_t instrument_id : instrument_ids) {
-        generate_update(instrument_id);
+    generate_block(instrument_ids);
+}
+
+void MarketDataGenerator::BlockScratch::resize(size_t count)
+{
+    if (refs.size() >= count) {
+        return;
     }
+    refs.resize(count);
+    tobs.resize(count);
+    kinds.resize(count);
+    sides.resize(count);
+    actions.resize(count);
+    sequences.resize(count);
+    quantities.resize(count);
+    reference_prices.resize(count);
+    tick_sizes.resize(count);
+    volatilities.resize(count);
+    drifts.resize(count);
+    normal_u1.resize(count);
+    normal_u2.resize(count);
+    prices.resize(count);
+    records.resize(count);
+}
+
+size_t MarketDataGenerator::generate_block(const uint32_t* instrument_ids, size_t count)
+{
+    BlockScratch& block = block_;
+    block.resize(count);
+
+    // Pass 1: look up books and draw every random input. Draws stay in the
+    // order generate_update makes them, so seeded streams line up.
+    size_t n = 0;
+    for (size_t i = 0; i < count; ++i) {
+        BookRef ref = book_manager_->get_book_ref(instrument_ids[i]);
+        if (!ref) {
+            continue;
+        }
+        begin_update(instrument_ids[i]);
+        stats_.updates_generated++;
+
+        const InstrumentRuntime& instrument = *ref.runtime;
+        const MarketConfig& config = config_for(instrument_ids[i]);
+        TopOfBook tob = ref.book->read_top_of_book();
+        block.refs[n] = ref;
+        block.tobs[n] = tob;
+        block.tick_sizes[n] = instrument.tick_size;
+        block.volatilities[n] = config.volatility;
+        block.drifts[n] = config.trend_bias * config.volatility;
+
+        if (should_generate_trade(config)) {
+            if (!tob.has_bid || !tob.has_ask) {
+                block.kinds[n++] = BlockScratch::NONE; // No market to trade against
+                continue;
+            }
+            block.kinds[n] = BlockScratch::TRADE;
+            block.sequences[n] = get_next_sequence(instrument_ids[i]);
+            block.sides[n] = choose_aggressor_side();
+            block.quantities[n] = calculate_quantity(instrument) / 2; // Trades typically smaller
+            block.reference_prices[n] = 0.0;
+            block.normal_u1[n] = 0.5;
+            block.normal_u2[n] = 0.0;
+        } else {
+            block.kinds[n] = BlockScratch::QUOTE;
+            block.sequences[n] = get_next_sequence(instrument_ids[i]);
+            block.sides[n] = (next_uniform() < 0.5) ? Side::BID : Side::ASK;
+            block.actions[n] = choose_update_action();
+            if (tob.has_bid && tob.has_ask) {
+                block.reference_prices[n] = (tob.bid_price + tob.ask_price) / 2.0;
+            } else {
+                block.reference_prices[n] = instrument.initial_price;
+            }
+            block.normal_u1[n] = next_uniform();
+            block.normal_u2[n] = next_uniform();
+            block.quantities[n] = calculate_quantity(instrument);
+        }
+        ++n;
+    }
+
+    // Pass 2: price moves over flat arrays, no branches on the event kind
+    double* prices = block.prices.data();
+    const double* reference = block.reference_prices.data();
+    const double* ticks = block.tick_sizes.data();
+    const double* volatility = block.volatilities.data();
+    const double* drift = block.drifts.data();
+    const double* u1 = block.normal_u1.data();
+    const double* u2 = block.normal_u2.data();
+    for (size_t i = 0; i < n; ++i) {
+        double normal = std::sqrt(-2.0 * std::log(1.0 - u1[i])) * std::cos(6.283185307179586 * u2[i]);
+        double trend = drift[i] * reference[i];
+        double random_move = normal * volatility[i] * reference[i];
+        prices[i] = std::round((reference[i] + (trend + random_move)) / ticks[i]) * ticks[i];
+    }
+
+    // Pass 3: build the records
+    uint64_t timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+                                .count();
+    size_t emitted = 0;
+    for (size_t i = 0; i < n; ++i) {
+        const BookRef& ref = block.refs[i];
+        const TopOfBook& tob = block.tobs[i];
+        uint32_t instrument_id = ref.instrument->instrument_id;
+        MarketEventRecord& record = block.records[emitted];
+
+        if (block.kinds[i] == BlockScratch::TRADE) {
+            record = MarketEventRecord::make_trade(instrument_id);
+            record.trade.aggressor_side = block.sides[i];
+            record.trade.price = (block.sides[i] == Side::BID) ? tob.ask_price : tob.bid_price;
+            record.trade.quantity = block.quantities[i];
+            stats_.trades_generated++;
+        } else if (block.kinds[i] == BlockScratch::QUOTE) {
+            record = MarketEventRecord::make_quote(instrument_id);
+            QuotePayload& quote = record.quote;
+            quote.side = block.sides[i];
+            quote.action = block.actions[i];
+            quote.price = prices[i];
+            if (quote.action == UpdateAction::ADD) {
+                if (quote.side == Side::BID && tob.has_bid) {
+                    quote.price = std::min(quote.price, tob.bid_price - block.tick_sizes[i]);
+                } else if (quote.side == Side::ASK && tob.has_ask) {
+                    quote.price = std::max(quote.price, tob.ask_price + block.tick_sizes[i]);
+                }
+            }
+            quote.quantity = block.quantities[i];
+            quote.order_count = std::max(1U, static_cast<uint32_t>(quote.quantity / 1000));
+            size_t depth = (quote.side == Side::BID) ? ref.book->bid_depth() : ref.book->ask_depth();
+            quote.price_level = static_cast<uint8_t>(depth + 1);
+            stats_.quotes_generated++;
+        } else {
+            continue;
+        }
+
+        record.timestamp_ns = timestamp_ns;
+        record.sequence_number = block.sequences[i];
+        ++emitted;
+    }
+
+    // Apply and publish in bulk
+    book_manager_->apply_records(block.records.data(), emitted);
+    dispatch_block(block.records.data(), emitted);
+    return emitted;
 }
 
 std::shared_ptr<QuoteEvent> MarketDataGenerator::generate_quote(uint32_t instrument_id)
 {
-    auto [instrument, book] = book_manager_->get_instrument_and_book(instrument_id);
-    if (!instrument || !book) {
+    begin_update(instrument_id);
+    MarketEventRecord record;
+    if (!generate_quote_record(instrument_id, record)) {
+        return nullptr;
+    }
+    return std::static_pointer_cast<QuoteEvent>(to_event(record));
+}
+
+std::shared_ptr<TradeEvent> MarketDataGenerator::generate_trade(uint32_t instrument_id)
+{
+    begin_update(instrument_id);
+    MarketEventRecord record;
+    if (!generate_trade_record(instrument_id, record)) {
         return nullptr;
     }
+    return std::static_pointer_cast<TradeEvent>(to_event(record));
+}
+
+bool MarketDataGenerator::generate_quote_record(uint32_t instrument_id, MarketEventRecord& record)
+{
+    BookRef ref = book_manager_->get_book_ref(instrument_id);
+    if (!ref) {
+        return false;
+    }
+    const InstrumentRuntime* instrument = ref.runtime;
+    const OrderBook* book = ref.book;
 
-    auto quote = std::make_shared<QuoteEvent>(instrument_id);
-    quote->timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    record = MarketEventRecord::make_quote(instrument_id);
+    record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::system_clock::now().time_since_epoch())
                               .count();
-    quote->sequence_number = get_next_sequence(instrument_id);
+    record.sequence_number = get_next_sequence(instrument_id);
+
+    QuotePayload& quote = record.quote;
 
     // Choose side
-    quote->side = (uniform_dist_(rng_) < 0.5) ? Side::BID : Side::ASK;
+    quote.side = (next_uniform() < 0.5) ? Side::BID : Side::ASK;
 
     // Choose action
-    quote->action = choose_update_action();
+    quote.action = choose_update_action();
 
-    // Get current best prices
-    auto best_bid = book->get_best_bid();
-    auto best_ask = book->get_best_ask();
+    // Get current best prices from the published BBO
+    TopOfBook tob = book->read_top_of_book();
 
     // Generate price based on current market
     double reference_price = 0.0;
-    if (best_bid && best_ask) {
-        reference_price = (*best_bid + *best_ask) / 2.0;
+    if (tob.has_bid && tob.has_ask) {
+        reference_price = (tob.bid_price + tob.ask_price) / 2.0;
     } else {
         // Use instrument's initial price if no market exists
-        auto initial_price = instrument->get_property<double>("initial_price");
-        reference_price = initial_price.value_or(100.0);
+        reference_price = instrument->initial_price;
     }
 
     // Apply price movement
-    double price_move = calculate_price_movement(reference_price, *instrument);
+    double price_move = calculate_price_movement(reference_price, config_for(instrument_id));
     double new_price = reference_price + price_move;
 
     // Round to tick size
-    quote->price = apply_tick_rounding(new_price, instrument->tick_size);
+    quote.price = apply_tick_rounding(new_price, instrument->tick_size);
 
     // Adjust price based on side and action
-    if (quote->side == Side::BID && best_bid) {
-        if (quote->action == UpdateAction::ADD) {
-            quote->price = std::min(quote->price, *best_bid - instrument->tick_size);
+    if (quote.side == Side::BID && tob.has_bid) {
+        if (quote.action == UpdateAction::ADD) {
+            quote.price = std::min(quote.price, tob.bid_price - instrument->tick_size);
         }
-    } else if (quote->side == Side::ASK && best_ask) {
-        if (quote->action == UpdateAction::ADD) {
-            quote->price = std::max(quote->price, *best_ask + instrument->tick_size);
+    } else if (quote.side == Side::ASK && tob.has_ask) {
+        if (quote.action == UpdateAction::ADD) {
+            quote.price = std::max(quote.price, tob.ask_price + instrument->tick_size);
         }
     }
 
-    quote->quantity = calculate_quantity(*instrument);
-    quote->order_count = std::max(1U, static_cast<uint32_t>(quote->quantity / 1000));
+    quote.quantity = calculate_quantity(*instrument);
+    quote.order_count = std::max(1U, static_cast<uint32_t>(quote.quantity / 1000));
 
     // Set price level (1-based)
-    if (quote->side == Side::BID) {
-        auto bids = book->get_bids();
-        quote->price_level = static_cast<uint8_t>(bids.size() + 1);
-    } else {
-        auto asks = book->get_asks();
-        quote->price_level = static_cast<uint8_t>(asks.size() + 1);
-    }
+    size_t depth = (quote.side == Side::BID) ? book->bid_depth() : book->ask_depth();
+    quote.price_level = static_cast<uint8_t>(depth + 1);
 
-    return quote;
+    return true;
 }
 
-std::shared_ptr<TradeEvent> MarketDataGenerator::generate_trade(uint32_t instrument_id)
+bool MarketDataGenerator::generate_trade_record(uint32_t instrument_id, MarketEventRecord& record)
 {
-    auto [instrument, book] = book_manager_->get_instrument_and_book(instrument_id);
-    if (!instrument || !book) {
-        return nullptr;
+    BookRef ref = book_manager_->get_book_ref(instrument_id);
+    if (!ref) {
+        return false;
     }
+    const InstrumentRuntime* instrument = ref.runtime;
+    const OrderBook* book = ref.book;
 
-    auto best_bid = book->get_best_bid();
-    auto best_ask = book->get_best_ask();
-
-    if (!best_bid || !best_ask) {
-        return nullptr; // No market to trade against
+    TopOfBook tob = book->read_top_of_book();
+    if (!tob.has_bid || !tob.has_ask) {
+        return false; // No market to trade against
     }
 
-    auto trade = std::make_shared<TradeEvent>(instrument_id);
-    trade->timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    record = MarketEventRecord::make_trade(instrument_id);
+    record.timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::system_clock::now().time_since_epoch())
                               .count();
-    trade->sequence_number = get_next_sequence(instrument_id);
+    record.sequence_number = get_next_sequence(instrument_id);
+
+    TradePayload& trade = record.trade;
 
     // Choose aggressor side
     Side aggressor = choose_aggressor_side();
-    trade->aggressor_side = aggressor;
+    trade.aggressor_side = aggressor;
 
     // Trade at best price of opposite side
     if (aggressor == Side::BID) {
-        trade->price = *best_ask; // Buy at offer
+        trade.price = tob.ask_price; // Buy at offer
     } else {
-        trade->price = *best_bid; // Sell at bid
+        trade.price = tob.bid_price; // Sell at bid
     }
 
-    trade->quantity = calculate_quantity(*instrument) / 2; // Trades typically smaller
+    trade.quantity = calculate_quantity(*instrument) / 2; // Trades typically smaller
 
-    return trade;
+    return true;
 }
 
 std::shared_ptr<StatisticsEvent> MarketDataGenerator::generate_statistics(uint32_t instrument_id)
 {
-    auto [instrument, book] = book_manager_->get_instrument_and_book(instrument_id);
-    if (!instrument || !book) {
+    BookRef ref = book_manager_->get_book_ref(instrument_id);
+    if (!ref) {
         return nullptr;
     }
+    const OrderBook* book = ref.book;
+    begin_update(instrument_id);
 
     auto stats_event = std::make_shared<StatisticsEvent>(instrument_id);
     stats_event->timestamp_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
@@ -221,8 +574,7 @@ std::shared_ptr<StatisticsEvent> MarketDataGenerator::generate_statistics(uint32
     const auto& book_stats = book->get_stats();
 
     // Generate different types of statistics
-    std::uniform_int_distribution<> stat_dist(0, 6);
-    int stat_choice = stat_dist(rng_);
+    int stat_choice = std::min(6, static_cast<int>(next_uniform() * 7));
 
     switch (stat_choice) {
     case 0:
@@ -261,7 +613,7 @@ std::shared_ptr<StatisticsEvent> MarketDataGenerator::generate_statistics(uint32
 
 std::shared_ptr<SnapshotEvent> MarketDataGenerator::generate_snapshot(uint32_t instrument_id)
 {
-    auto snapshot = book_manager_->create_snapshot(instrument_id, config_.book_depth_target);
+    auto snapshot = book_manager_->create_snapshot(instrument_id, config_for(instrument_id).book_depth_target);
     if (snapshot) {
         snapshot->sequence_number = get_next_sequence(instrument_id);
         stats_.snapshots_generated++;
@@ -269,29 +621,69 @@ std::shared_ptr<SnapshotEvent> MarketDataGenerator::generate_snapshot(uint32_t i
     return snapshot;
 }
 
-void MarketDataGenerator::add_listener(std::weak_ptr<IMarketEventListener> listener)
+void MarketDataGenerator::add_listener(std::shared_ptr<IMarketEventListener> listener)
 {
+    if (!listener) {
+        return;
+    }
     std::lock_guard<std::mutex> lock(listeners_mutex_);
-    listeners_.push_back(listener);
+    auto listeners = current_listeners();
+    listeners.push_back(std::move(listener));
+    publish_listeners(std::move(listeners));
 }
 
-void MarketDataGenerator::remove_listener(std::shared_ptr<IMarketEventListener> listener)
+bool MarketDataGenerator::remove_listener(const std::shared_ptr<IMarketEventListener>& listener)
 {
     std::lock_guard<std::mutex> lock(listeners_mutex_);
-    // Remove by comparing the locked weak_ptr
-    listeners_.erase(
-        std::remove_if(listeners_.begin(), listeners_.end(),
-            [&listener](const std::weak_ptr<IMarketEventListener>& wp) {
-                auto sp = wp.lock();
-                return !sp || sp == listener;
-            }),
-        listeners_.end());
+    auto listeners = current_listeners();
+    auto kept = std::remove(listeners.begin(), listeners.end(), listener);
+    if (kept == listeners.end()) {
+        return false;
+    }
+    listeners.erase(kept, listeners.end());
+    publish_listeners(std::move(listeners));
+    return true;
 }
 
 void MarketDataGenerator::clear_listeners()
 {
     std::lock_guard<std::mutex> lock(listeners_mutex_);
-    listeners_.clear();
+    publish_listeners({});
+}
+
+std::vector<std::shared_ptr<IMarketEventListener>> MarketDataGenerator::current_listeners() const
+{
+    // Caller holds listeners_mutex_
+    const ListenerSnapshot* current = listener_snapshot_.load(std::memory_order_relaxed);
+    return current ? current->listeners : std::vector<std::shared_ptr<IMarketEventListener>> {};
+}
+
+void MarketDataGenerator::publish_listeners(std::vector<std::shared_ptr<IMarketEventListener>> listeners)
+{
+    // Caller holds listeners_mutex_
+    auto* next = new ListenerSnapshot { std::move(listeners) };
+    const ListenerSnapshot* previous = listener_snapshot_.exchange(next, std::memory_order_seq_cst);
+    if (previous) {
+        retired_snapshots_.emplace_back(previous);
+    }
+
+    // A dispatch that starts after the swap only sees the new snapshot, so
+    // with none in flight every retired one is unreachable
+    if (dispatches_in_flight_.load(std::memory_order_seq_cst) == 0) {
+        retired_snapshots_.clear();
+    }
+}
+
+template <typename Event>
+void MarketDataGenerator::dispatch(const Event& event)
+{
+    dispatches_in_flight_.fetch_add(1, std::memory_order_seq_cst);
+    if (const ListenerSnapshot* snapshot = listener_snapshot_.load(std::memory_order_seq_cst)) {
+        for (const auto& listener : snapshot->listeners) {
+            listener->on_market_event(event);
+        }
+    }
+    dispatches_in_flight_.fetch_sub(1, std::memory_order_release);
 }
 
 void MarketDataGenerator::reset_statistics()
@@ -299,6 +691,22 @@ void MarketDataGenerator::reset_statistics()
     stats_ = Statistics {};
     stats_.start_time = std::chrono::steady_clock::now();
     instrument_sequences_.clear();
+    update_counts_.clear();
+    batch_count_ = 0;
+}
+
+void MarketDataGenerator::dispatch_block(const MarketEventRecord* records, size_t count)
+{
+    if (count == 0) {
+        return;
+    }
+    dispatches_in_flight_.fetch_add(1, std::memory_order_seq_cst);
+    if (const ListenerSnapshot* snapshot = listener_snapshot_.load(std::memory_order_seq_cst)) {
+        for (const auto& listener : snapshot->listeners) {
+            listener->on_market_events(records, count);
+        }
+    }
+    dispatches_in_flight_.fetch_sub(1, std::memory_order_release);
 }
 
 void MarketDataGenerator::notify_listeners(const std::shared_ptr<MarketEvent>& event)
@@ -307,63 +715,64 @@ void MarketDataGenerator::notify_listeners(const std::shared_ptr<MarketEvent>& e
     book_manager_->apply_event(event);
 
     // Notify protocol adapters
-    std::lock_guard<std::mutex> lock(listeners_mutex_);
-    for (auto& listener : listeners_) {
-        if (auto shared_listener = listener.lock()) {
-            shared_listener->on_market_event(event);
-        }
-    }
+    dispatch(event);
+}
 
-    // Remove expired weak pointers
-    listeners_.erase(
-        std::remove_if(listeners_.begin(), listeners_.end(),
-            [](const std::weak_ptr<IMarketEventListener>& wp) {
-                return wp.expired();
-            }),
-        listeners_.end());
+void MarketDataGenerator::notify_listeners(const MarketEventRecord& record)
+{
+    // Apply to local books first
+    book_manager_->apply_record(record);
+
+    // Notify protocol adapters
+    dispatch(record);
 }
 
-double MarketDataGenerator::calculate_price_movement(double current_price, const Instrument& instrument)
+double MarketDataGenerator::calculate_price_movement(double current_price, const MarketConfig& config)
 {
     // Base volatility
-    double vol = config_.volatility;
+    double vol = config.volatility;
 
     // Apply trend bias
-    double trend = config_.trend_bias * vol * current_price;
+    double trend = config.trend_bias * vol * current_price;
 
     // Random component
-    double random_move = normal_dist_(rng_) * vol * current_price;
+    double random_move = next_normal() * vol * current_price;
 
     return trend + random_move;
 }
 
-uint64_t MarketDataGenerator::calculate_quantity(const Instrument& instrument)
+uint64_t MarketDataGenerator::calculate_quantity(const InstrumentRuntime& instrument)
 {
     // Use Poisson distribution for realistic quantity distribution
-    std::poisson_distribution<> qty_dist(static_cast<double>(poisson_dist_.param().mean()));
-    uint64_t base_qty = qty_dist(rng_) * 100; // Multiples of 100
+    uint64_t base_qty;
+    if (seeded_) {
+        base_qty = uint64_t(event_rng_.poisson(poisson_dist_.mean())) * 100; // Multiples of 100
+    } else {
+        std::poisson_distribution<> qty_dist(static_cast<double>(poisson_dist_.param().mean()));
+        base_qty = qty_dist(rng_) * 100; // Multiples of 100
+    }
 
     // Adjust based on instrument type
-    if (instrument.get_type() == InstrumentType::FX_SPOT) {
+    if (instrument.type == InstrumentType::FX_SPOT) {
         base_qty *= 10000; // FX trades in larger sizes
     }
 
     return std::max(uint64_t(100), base_qty);
 }
 
-bool MarketDataGenerator::should_generate_trade()
+bool MarketDataGenerator::should_generate_trade(const MarketConfig& config)
 {
-    return uniform_dist_(rng_) < config_.trade_probability;
+    return next_uniform() < config.trade_probability;
 }
 
 Side MarketDataGenerator::choose_aggressor_side()
 {
-    return (uniform_dist_(rng_) < 0.5) ? Side::BID : Side::ASK;
+    return (next_uniform() < 0.5) ? Side::BID : Side::ASK;
 }
 
 UpdateAction MarketDataGenerator::choose_update_action()
 {
-    double rand = uniform_dist_(rng_);
+    double rand = next_uniform();
     if (rand < 0.6) {
         return UpdateAction::ADD;
     } else if (rand < 0.8) {
@@ -0,0 +1,138 @@
+#include "../include/market_event_record.h"
+#include <cstdlib>
+#include <string>
+
+namespace market_core {
+
+QuotePayload to_quote_payload(const QuoteEvent& quote)
+{
+    QuotePayload payload {};
+    payload.price = quote.price;
+    payload.quantity = quote.quantity;
+    payload.order_id = quote.order_id;
+    payload.implied_quantity = quote.implied_quantity;
+    payload.order_count = quote.order_count;
+    payload.side = quote.side;
+    payload.action = quote.action;
+    payload.price_level = quote.price_level;
+    payload.contributor_id = quote.contributor_id;
+    return payload;
+}
+
+bool to_record(const MarketEvent& event, MarketEventRecord& record)
+{
+    switch (event.type) {
+    case MarketEvent::QUOTE_UPDATE: {
+        const auto& quote = static_cast<const QuoteEvent&>(event);
+        record = MarketEventRecord::make_quote(event.instrument_id);
+        record.quote = to_quote_payload(quote);
+        record.rpt_seq = quote.rpt_seq.value_or(0);
+        break;
+    }
+    case MarketEvent::TRADE: {
+        const auto& trade = static_cast<const TradeEvent&>(event);
+        record = MarketEventRecord::make_trade(event.instrument_id);
+        record.trade.price = trade.price;
+        record.trade.quantity = trade.quantity;
+        record.trade.aggressor_side = trade.aggressor_side.value_or(Side::NONE);
+        if (trade.trade_id) {
+            char* end = nullptr;
+            unsigned long long id = std::strtoull(trade.trade_id->c_str(), &end, 10);
+            record.trade.trade_id = (end && *end == '\0') ? id : 0;
+        }
+        record.rpt_seq = trade.rpt_seq.value_or(0);
+        break;
+    }
+    case MarketEvent::STATISTICS: {
+        const auto& stats = static_cast<const StatisticsEvent&>(event);
+        record = MarketEventRecord::make_statistics(event.instrument_id);
+        record.statistics.stat_type = stats.stat_type;
+        record.statistics.value = stats.value;
+        record.statistics.volume = stats.volume.value_or(0);
+        break;
+    }
+    case MarketEvent::STATUS_CHANGE: {
+        const auto& status = static_cast<const StatusEvent&>(event);
+        record = MarketEventRecord::make_status(event.instrument_id);
+        record.status.status = status.status;
+        break;
+    }
+    case MarketEvent::BOOK_CLEAR:
+        record = MarketEventRecord::make_book_clear(event.instrument_id);
+        break;
+    default:
+        return false;
+    }
+
+    record.timestamp_ns = event.timestamp_ns;
+    record.sequence_number = event.sequence_number;
+    return true;
+}
+
+std::shared_ptr<MarketEvent> to_event(const MarketEventRecord& record)
+{
+    std::shared_ptr<MarketEvent> event;
+
+    switch (record.type) {
+    case MarketEvent::QUOTE_UPDATE: {
+        auto quote = std::make_shared<QuoteEvent>(record.instrument_id);
+        quote->side = record.quote.side;
+        quote->action = record.quote.action;
+        quote->contributor_id = record.quote.contributor_id;
+        quote->price_level = record.quote.price_level;
+        quote->order_count = record.quote.order_count;
+        quote->price = record.quote.price;
+        quote->quantity = record.quote.quantity;
+        quote->order_id = record.quote.order_id;
+        quote->implied_quantity = record.quote.implied_quantity;
+        if (record.rpt_seq) {
+            quote->rpt_seq = record.rpt_seq;
+        }
+        event = quote;
+        break;
+    }
+    case MarketEvent::TRADE: {
+        auto trade = std::make_shared<TradeEvent>(record.instrument_id);
+        trade->price = record.trade.price;
+        trade->quantity = record.trade.quantity;
+        if (record.trade.aggressor_side != Side::NONE) {
+            trade->aggressor_side = record.trade.aggressor_side;
+        }
+        if (record.trade.trade_id) {
+            trade->trade_id = std::to_string(record.trade.trade_id);
+        }
+        if (record.rpt_seq) {
+            trade->rpt_seq = record.rpt_seq;
+        }
+        event = trade;
+        break;
+    }
+    case MarketEvent::STATISTICS: {
+        auto stats = std::make_shared<StatisticsEvent>(record.instrument_id);
+        stats->stat_type = record.statistics.stat_type;
+        stats->value = record.statistics.value;
+        if (record.statistics.volume) {
+            stats->volume = record.statistics.volume;
+        }
+        event = stats;
+        break;
+    }
+    case MarketEvent::STATUS_CHANGE: {
+        auto status = std::make_shared<StatusEvent>(record.instrument_id);
+        status->status = record.status.status;
+        event = status;
+        break;
+    }
+    case MarketEvent::BOOK_CLEAR:
+        event = std::make_shared<MarketEvent>(MarketEvent::BOOK_CLEAR, record.instrument_id);
+        break;
+    default:
+        return nullptr;
+    }
+
+    event->timestamp_ns = record.timestamp_ns;
+    event->sequence_number = record.sequence_number;
+    return event;
+}
+
+} // namespace market_core
@@ -2,6 +2,7 @@
 #include <algorithm>
 #include <chrono>
 #include <cmath>
+#include <cstring>
 
 namespace market_core {
 
@@ -9,16 +10,82 @@ OrderBook::OrderBook(uint32_t instrument_id, const std::string& symbol)
     : instrument_id_(instrument_id)
     , symbol_(symbol)
     , config_()
+    , recent_trades_(config_.trade_history_capacity)
 {
 }
 
+OrderBook::OrderBook(uint32_t instrument_id, const std::string& symbol, const Config& config)
+    : instrument_id_(instrument_id)
+    , symbol_(symbol)
+    , config_(config)
+    , recent_trades_(config.trade_history_capacity)
+{
+    set_config(config);
+}
+
+void OrderBook::set_config(const Config& config)
+{
+    config_ = config;
+
+    if (recent_trades_.capacity() != config_.trade_history_capacity) {
+        // Keep the newest trades that still fit
+        TradeRing resized(config_.trade_history_capacity);
+        for (const auto& trade : recent_trades_.latest(config_.trade_history_capacity)) {
+            resized.push(trade);
+        }
+        recent_trades_ = std::move(resized);
+    }
+
+    if (!config_.aggregate_by_price && !orders_) {
+        orders_ = std::make_unique<OrderLevelBook>(config_.tick_size);
+    } else if (config_.aggregate_by_price) {
+        orders_.reset(); // Aggregated levels stay, order detail is dropped
+    }
+
+    bool use_ladder = config_.engine == Config::Engine::TICK_LADDER && config_.tick_size > 0.0;
+    if (use_ladder == static_cast<bool>(bid_ladder_)) {
+        return;
+    }
+
+    // Move existing levels into the newly selected storage
+    std::vector<PriceLevel> bid_levels;
+    std::vector<PriceLevel> ask_levels;
+    visit_side(Side::BID, SIZE_MAX, [&](const PriceLevel& level) { bid_levels.push_back(level); });
+    visit_side(Side::ASK, SIZE_MAX, [&](const PriceLevel& level) { ask_levels.push_back(level); });
+
+    bids_.clear();
+    asks_.clear();
+    if (use_ladder) {
+        bid_ladder_ = std::make_unique<PriceLadder>(Side::BID, config_.tick_size, config_.ladder_window_ticks);
+        ask_ladder_ = std::make_unique<PriceLadder>(Side::ASK, config_.tick_size, config_.ladder_window_ticks);
+    } else {
+        bid_ladder_.reset();
+        ask_ladder_.reset();
+    }
+
+    for (const auto& level : bid_levels) {
+        add_level(Side::BID, level);
+    }
+    for (const auto& level : ask_levels) {
+        add_level(Side::ASK, level);
+    }
+}
+
 void OrderBook::add_level(Side side, const PriceLevel& level)
 {
-    if (side == Side::BID) {
+    if (bid_ladder_) {
+        if (side == Side::BID) {
+            bid_ladder_->set(level);
+        } else if (side == Side::ASK) {
+            ask_ladder_->set(level);
+        }
+    } else if (side == Side::BID) {
         bids_[level.price] = level;
     } else if (side == Side::ASK) {
         asks_[level.price] = level;
     }
+
+    publish_top_of_book();
 }
 
 void OrderBook::update_level(Side side, const PriceLevel& level)
@@ -28,108 +95,167 @@ void OrderBook::update_level(Side side, const PriceLevel& level)
         return;
     }
 
-    if (side == Side::BID) {
-        bids_[level.price] = level;
-    } else if (side == Side::ASK) {
-        asks_[level.price] = level;
-    }
+    add_level(side, level);
 }
 
 void OrderBook::remove_level(Side side, double price)
 {
-    if (side == Side::BID) {
+    if (bid_ladder_) {
+        if (side == Side::BID) {
+            bid_ladder_->erase(price);
+        } else if (side == Side::ASK) {
+            ask_ladder_->erase(price);
+        }
+    } else if (side == Side::BID) {
         bids_.erase(price);
     } else if (side == Side::ASK) {
         asks_.erase(price);
     }
+
+    auto& implied = (side == Side::BID) ? implied_bids_ : implied_asks_;
+    if (!implied.empty()) {
+        implied.erase(price_key(price));
+    }
+
+    publish_top_of_book();
 }
 
 void OrderBook::clear_side(Side side)
 {
+    if (orders_) {
+        orders_->clear_side(side);
+    }
+
     if (side == Side::BID) {
         bids_.clear();
+        implied_bids_.clear();
+        if (bid_ladder_) {
+            bid_ladder_->clear();
+        }
     } else if (side == Side::ASK) {
         asks_.clear();
+        implied_asks_.clear();
+        if (ask_ladder_) {
+            ask_ladder_->clear();
+        }
     }
+
+    publish_top_of_book();
 }
 
 void OrderBook::clear()
 {
-    bids_.clear();
-    asks_.clear();
+    clear_side(Side::BID);
+    clear_side(Side::ASK);
     recent_trades_.clear();
     stats_ = MarketStats {};
 }
 
-void OrderBook::add_trade(const Trade& trade)
+void OrderBook::set_implied_quantity(Side side, double price, uint64_t quantity)
 {
-    recent_trades_.push_back(trade);
+    if (!config_.maintain_implied_prices || side == Side::NONE) {
+        return;
+    }
+
+    auto& implied = (side == Side::BID) ? implied_bids_ : implied_asks_;
+    if (quantity == 0) {
+        implied.erase(price_key(price));
+    } else {
+        implied[price_key(price)] = quantity;
+    }
+}
 
-    // Keep only recent trades
-    if (recent_trades_.size() > 100) {
-        recent_trades_.erase(recent_trades_.begin());
+std::optional<uint64_t> OrderBook::get_implied_quantity(Side side, double price) const
+{
+    const auto& implied = (side == Side::BID) ? implied_bids_ : implied_asks_;
+    auto it = implied.find(price_key(price));
+    if (it == implied.end()) {
+        return std::nullopt;
     }
+    return it->second;
+}
 
+void OrderBook::add_trade(const Trade& trade)
+{
+    recent_trades_.push(trade);
     update_stats_on_trade(trade);
 }
 
-std::vector<PriceLevel> OrderBook::get_bids(size_t max_levels) const
+bool OrderBook::add_order(uint64_t order_id, Side side, double price, uint64_t quantity, uint64_t timestamp_ns)
 {
-    std::vector<PriceLevel> result;
-    result.reserve(std::min(max_levels, bids_.size()));
+    OrderLevelBook::LevelChange change;
+    if (!orders_ || !orders_->add(order_id, side, price, quantity, timestamp_ns, change)) {
+        return false;
+    }
+    apply_level_change(change);
+    return true;
+}
 
-    size_t count = 0;
-    for (const auto& [price, level] : bids_) {
-        if (count >= max_levels)
-            break;
-        result.push_back(level);
-        ++count;
+bool OrderBook::modify_order(uint64_t order_id, double price, uint64_t quantity, uint64_t timestamp_ns)
+{
+    if (!orders_) {
+        return false;
     }
 
-    return result;
+    OrderLevelBook::LevelChange changes[2];
+    size_t count = orders_->modify(order_id, price, quantity, timestamp_ns, changes);
+    for (size_t i = 0; i < count; ++i) {
+        apply_level_change(changes[i]);
+    }
+    return count > 0;
 }
 
-std::vector<PriceLevel> OrderBook::get_asks(size_t max_levels) const
+bool OrderBook::cancel_order(uint64_t order_id)
 {
-    std::vector<PriceLevel> result;
-    result.reserve(std::min(max_levels, asks_.size()));
-
-    size_t count = 0;
-    for (const auto& [price, level] : asks_) {
-        if (count >= max_levels)
-            break;
-        result.push_back(level);
-        ++count;
+    OrderLevelBook::LevelChange change;
+    if (!orders_ || !orders_->cancel(order_id, change)) {
+        return false;
     }
+    apply_level_change(change);
+    return true;
+}
+
+const Order* OrderBook::get_order(uint64_t order_id) const
+{
+    return orders_ ? orders_->find(order_id) : nullptr;
+}
+
+size_t OrderBook::queue_position(uint64_t order_id) const
+{
+    return orders_ ? orders_->queue_position(order_id) : 0;
+}
 
+std::vector<PriceLevel> OrderBook::get_bids(size_t max_levels) const
+{
+    std::vector<PriceLevel> result;
+    result.reserve(std::min(max_levels, bid_depth()));
+    visit_bids(max_levels, [&](const PriceLevel& level) { result.push_back(level); });
     return result;
 }
 
-std::vector<Trade> OrderBook::get_recent_trades(size_t count) const
+std::vector<PriceLevel> OrderBook::get_asks(size_t max_levels) const
 {
-    if (count >= recent_trades_.size()) {
-        return recent_trades_;
-    }
+    std::vector<PriceLevel> result;
+    result.reserve(std::min(max_levels, ask_depth()));
+    visit_asks(max_levels, [&](const PriceLevel& level) { result.push_back(level); });
+    return result;
+}
 
-    return std::vector<Trade>(
-        recent_trades_.end() - count,
-        recent_trades_.end());
+TradeHistoryView OrderBook::get_recent_trades(size_t count) const
+{
+    return recent_trades_.latest(count);
 }
 
 std::optional<double> OrderBook::get_best_bid() const
 {
-    if (bids_.empty()) {
-        return std::nullopt;
-    }
-    return bids_.begin()->first;
+    const PriceLevel* best = best_level(Side::BID);
+    return best ? std::optional<double>(best->price) : std::nullopt;
 }
 
 std::optional<double> OrderBook::get_best_ask() const
 {
-    if (asks_.empty()) {
-        return std::nullopt;
-    }
-    return asks_.begin()->first;
+    const PriceLevel* best = best_level(Side::ASK);
+    return best ? std::optional<double>(best->price) : std::nullopt;
 }
 
 std::optional<double> OrderBook::get_mid_price() const
@@ -174,48 +300,44 @@ std::shared_ptr<SnapshotEvent> OrderBook::create_snapshot_event(size_t max_level
         std::chrono::system_clock::now().time_since_epoch())
                    .count();
     snapshot->timestamp_ns = now;
+    snapshot->bid_levels.reserve(std::min(max_levels, bid_depth()));
+    snapshot->ask_levels.reserve(std::min(max_levels, ask_depth()));
 
     // Add bid levels
     size_t bid_count = 0;
-    for (const auto& [price, level] : bids_) {
-        if (bid_count >= max_levels)
-            break;
-
+    visit_bids(max_levels, [&](const PriceLevel& level) {
         QuoteEvent bid_quote(instrument_id_);
         bid_quote.side = Side::BID;
         bid_quote.price = level.price;
         bid_quote.quantity = level.quantity;
         bid_quote.order_count = level.order_count;
-        if (level.level_number) {
-            bid_quote.price_level = *level.level_number;
-        } else {
-            bid_quote.price_level = static_cast<uint8_t>(bid_count + 1);
+        bid_quote.contributor_id = level.contributor_id;
+        bid_quote.price_level = level.level_number ? level.level_number : static_cast<uint8_t>(bid_count + 1);
+        if (!implied_bids_.empty()) {
+            bid_quote.implied_quantity = get_implied_quantity(Side::BID, level.price).value_or(0);
         }
 
         snapshot->bid_levels.push_back(bid_quote);
         ++bid_count;
-    }
+    });
 
     // Add ask levels
     size_t ask_count = 0;
-    for (const auto& [price, level] : asks_) {
-        if (ask_count >= max_levels)
-            break;
-
+    visit_asks(max_levels, [&](const PriceLevel& level) {
         QuoteEvent ask_quote(instrument_id_);
         ask_quote.side = Side::ASK;
         ask_quote.price = level.price;
         ask_quote.quantity = level.quantity;
         ask_quote.order_count = level.order_count;
-        if (level.level_number) {
-            ask_quote.price_level = *level.level_number;
-        } else {
-            ask_quote.price_level = static_cast<uint8_t>(ask_count + 1);
+        ask_quote.contributor_id = level.contributor_id;
+        ask_quote.price_level = level.level_number ? level.level_number : static_cast<uint8_t>(ask_count + 1);
+        if (!implied_asks_.empty()) {
+            ask_quote.implied_quantity = get_implied_quantity(Side::ASK, level.price).value_or(0);
         }
 
         snapshot->ask_levels.push_back(ask_quote);
         ++ask_count;
-    }
+    });
 
     // Add statistics
     snapshot->last_trade_price = (stats_.last_price > 0) ? std::optional<double>(stats_.last_price) : std::nullopt;
@@ -226,27 +348,153 @@ std::shared_ptr<SnapshotEvent> OrderBook::create_snapshot_event(size_t max_level
 
 void OrderBook::apply_event(const std::shared_ptr<MarketEvent>& event)
 {
-    switch (event->type) {
-    case MarketEvent::EventType::QUOTE_UPDATE: {
-        auto quote = std::static_pointer_cast<QuoteEvent>(event);
-        apply_quote_event(*quote);
+    apply_event(*event);
+}
+
+void OrderBook::apply_event(const MarketEvent& event)
+{
+    last_sequence_ = event.sequence_number;
+    switch (event.type) {
+    case MarketEvent::EventType::QUOTE_UPDATE:
+        apply_quote(to_quote_payload(static_cast<const QuoteEvent&>(event)), event.timestamp_ns);
         break;
-    }
-    case MarketEvent::EventType::TRADE: {
-        auto trade = std::static_pointer_cast<TradeEvent>(event);
-        apply_trade_event(*trade);
+    case MarketEvent::EventType::TRADE:
+        apply_trade_event(static_cast<const TradeEvent&>(event));
         break;
-    }
-    case MarketEvent::EventType::BOOK_CLEAR: {
+    case MarketEvent::EventType::BOOK_CLEAR:
         clear();
         break;
+    default:
+        // Ignore other event types for now
+        break;
+    }
+}
+
+void OrderBook::apply_events(const MarketEvent* const* events, size_t count)
+{
+    bool opened = begin_batch();
+    for (size_t i = 0; i < count; ++i) {
+        apply_event(*events[i]);
+    }
+    if (opened) {
+        end_batch();
+    }
+}
+
+void OrderBook::apply_events(const std::shared_ptr<MarketEvent>* events, size_t count)
+{
+    bool opened = begin_batch();
+    for (size_t i = 0; i < count; ++i) {
+        if (events[i]) {
+            apply_event(*events[i]);
+        }
+    }
+    if (opened) {
+        end_batch();
     }
+}
+
+void OrderBook::apply_record(const MarketEventRecord& record)
+{
+    last_sequence_ = record.sequence_number;
+    switch (record.type) {
+    case MarketEvent::EventType::QUOTE_UPDATE:
+        apply_quote(record.quote, record.timestamp_ns);
+        break;
+    case MarketEvent::EventType::TRADE:
+        apply_trade(record.trade, record.timestamp_ns);
+        break;
+    case MarketEvent::EventType::BOOK_CLEAR:
+        clear();
+        break;
     default:
         // Ignore other event types for now
         break;
     }
 }
 
+void OrderBook::apply_records(const MarketEventRecord* records, size_t count)
+{
+    bool opened = begin_batch();
+    for (size_t i = 0; i < count; ++i) {
+        apply_record(records[i]);
+    }
+    if (opened) {
+        end_batch();
+    }
+}
+
+bool OrderBook::begin_batch()
+{
+    if (defer_publish_) {
+        return false;
+    }
+    defer_publish_ = true;
+    return true;
+}
+
+void OrderBook::end_batch()
+{
+    defer_publish_ = false;
+    if (publish_pending_) {
+        publish_top_of_book();
+    }
+}
+
+// Ticks when the book has a tick size, otherwise the exact price bits (as the map engine keys)
+int64_t OrderBook::price_key(double price) const
+{
+    if (config_.tick_size > 0.0) {
+        return std::llround(price / config_.tick_size);
+    }
+    int64_t bits;
+    std::memcpy(&bits, &price, sizeof(bits));
+    return bits;
+}
+
+const PriceLevel* OrderBook::best_level(Side side) const
+{
+    if (side == Side::BID) {
+        if (bid_ladder_) {
+            return bid_ladder_->best();
+        }
+        return bids_.empty() ? nullptr : &bids_.begin()->second;
+    }
+
+    if (ask_ladder_) {
+        return ask_ladder_->best();
+    }
+    return asks_.empty() ? nullptr : &asks_.begin()->second;
+}
+
+void OrderBook::publish_top_of_book()
+{
+    if (defer_publish_) {
+        publish_pending_ = true;
+        return;
+    }
+    publish_pending_ = false;
+
+    TopOfBook tob;
+    tob.version = ++version_;
+
+    if (const PriceLevel* bid = best_level(Side::BID)) {
+        tob.has_bid = true;
+        tob.bid_price = bid->price;
+        tob.bid_quantity = bid->quantity;
+        tob.bid_order_count = bid->order_count;
+    }
+
+    if (const PriceLevel* ask = best_level(Side::ASK)) {
+        tob.has_ask = true;
+        tob.ask_price = ask->price;
+        tob.ask_quantity = ask->quantity;
+        tob.ask_order_count = ask->order_count;
+    }
+
+    top_of_book_.publish(tob);
+}
+
 void OrderBook::update_stats_on_trade(const Trade& trade)
 {
     stats_.last_price = trade.price;
@@ -275,13 +523,34 @@ void OrderBook::update_stats_on_trade(const Trade& trade)
     }
 }
 
-void OrderBook::apply_quote_event(const QuoteEvent& quote)
+void OrderBook::apply_level_change(const OrderLevelBook::LevelChange& change)
 {
+    if (change.order_count == 0) {
+        remove_level(change.side, change.price);
+        return;
+    }
+
+    PriceLevel level {};
+    level.price = change.price;
+    level.quantity = change.quantity;
+    level.order_count = change.order_count;
+    level.last_update_time = change.timestamp_ns;
+    add_level(change.side, level);
+}
+
+void OrderBook::apply_quote(const QuotePayload& quote, uint64_t timestamp_ns)
+{
+    if (orders_ && quote.order_id != 0) {
+        apply_order_quote(quote, timestamp_ns);
+        return;
+    }
+
     PriceLevel level;
     level.price = quote.price;
     level.quantity = quote.quantity;
     level.order_count = quote.order_count;
-    level.last_update_time = quote.timestamp_ns;
+    level.last_update_time = timestamp_ns;
+    level.contributor_id = quote.contributor_id;
     level.level_number = quote.price_level;
 
     switch (quote.action) {
@@ -289,6 +558,9 @@ void OrderBook::apply_quote_event(const QuoteEvent& quote)
     case UpdateAction::CHANGE:
     case UpdateAction::OVERLAY:
         update_level(quote.side, level);
+        if (quote.quantity > 0) {
+            set_implied_quantity(quote.side, quote.price, quote.implied_quantity);
+        }
         break;
     case UpdateAction::DELETE:
         remove_level(quote.side, quote.price);
@@ -299,6 +571,41 @@ void OrderBook::apply_quote_event(const QuoteEvent& quote)
     }
 }
 
+void OrderBook::apply_order_quote(const QuotePayload& quote, uint64_t timestamp_ns)
+{
+    switch (quote.action) {
+    case UpdateAction::ADD:
+        add_order(quote.order_id, quote.side, quote.price, quote.quantity, timestamp_ns);
+        break;
+    case UpdateAction::CHANGE:
+    case UpdateAction::OVERLAY:
+        if (!modify_order(quote.order_id, quote.price, quote.quantity, timestamp_ns)) {
+            add_order(quote.order_id, quote.side, quote.price, quote.quantity, timestamp_ns);
+        }
+        break;
+    case UpdateAction::DELETE:
+        cancel_order(quote.order_id);
+        break;
+    case UpdateAction::CLEAR:
+        clear_side(quote.side);
+        break;
+    }
+}
+
+void OrderBook::apply_trade(const TradePayload& trade_payload, uint64_t timestamp_ns)
+{
+    Trade trade;
+    trade.price = trade_payload.price;
+    trade.quantity = trade_payload.quantity;
+    trade.timestamp_ns = timestamp_ns;
+    if (trade_payload.aggressor_side != Side::NONE) {
+        trade.aggressor_side = trade_payload.aggressor_side;
+    }
+    trade.trade_number = trade_payload.trade_id;
+
+    add_trade(trade);
+}
+
 void OrderBook::apply_trade_event(const TradeEvent& trade_event)
 {
     Trade trade;
@@ -3,43 +3,57 @@
 
 namespace market_core {
 
-bool OrderBookManager::add_instrument(std::shared_ptr<Instrument> instrument)
+OrderBookManager::OrderBookManager(size_t shard_count)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    size_t shards = 1;
+    while (shards < shard_count && shards < MAX_SHARD_COUNT) {
+        shards <<= 1;
+    }
+    shards_.reset(new Shard[shards]);
+    shard_mask_ = shards - 1;
+}
 
+bool OrderBookManager::add_instrument(std::shared_ptr<Instrument> instrument)
+{
     if (!instrument) {
         return false;
     }
 
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+
     uint32_t id = instrument->instrument_id;
-    if (instruments_.find(id) != instruments_.end()) {
+    if (slot_index_.find(id)) {
         return false; // Already exists
     }
 
-    instruments_[id] = instrument;
+    auto slot_number = static_cast<uint32_t>(slots_.size());
+    InstrumentSlot* slot = slots_.emplace_back([&](InstrumentSlot& entry) {
+        entry.runtime = InstrumentRuntime::resolve(*instrument);
+        entry.instrument = std::move(instrument);
+        entry.slot = slot_number;
+    });
+    if (!slot) {
+        return false; // Registry full
+    }
+    slot_index_.insert(id, slot);
     return true;
 }
 
 std::shared_ptr<Instrument> OrderBookManager::get_instrument(uint32_t instrument_id) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto it = instruments_.find(instrument_id);
-    if (it != instruments_.end()) {
-        return it->second;
-    }
-    return nullptr;
+    const InstrumentSlot* slot = slot_index_.find(instrument_id);
+    return slot ? slot->instrument : nullptr;
 }
 
 std::vector<std::shared_ptr<Instrument>> OrderBookManager::get_all_instruments() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = slots_.size();
 
     std::vector<std::shared_ptr<Instrument>> result;
-    result.reserve(instruments_.size());
+    result.reserve(count);
 
-    for (const auto& [id, instrument] : instruments_) {
-        result.push_back(instrument);
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(slots_[i].instrument);
     }
 
     return result;
@@ -47,13 +61,13 @@ std::vector<std::shared_ptr<Instrument>> OrderBookManager::get_all_instruments()
 
 std::vector<uint32_t> OrderBookManager::get_all_instrument_ids() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = slots_.size();
 
     std::vector<uint32_t> result;
-    result.reserve(instruments_.size());
+    result.reserve(count);
 
-    for (const auto& [id, instrument] : instruments_) {
-        result.push_back(id);
+    for (size_t i = 0; i < count; ++i) {
+        result.push_back(slots_[i].instrument->instrument_id);
     }
 
     return result;
@@ -63,44 +77,59 @@ bool OrderBookManager::create_order_book(
     uint32_t instrument_id,
     const OrderBook::Config& config)
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(registry_mutex_);
 
-    if (!validate_instrument(instrument_id)) {
+    InstrumentSlot* slot = slot_index_.find(instrument_id);
+    if (!slot) {
         return false; // Instrument doesn't exist
     }
 
-    if (order_books_.find(instrument_id) != order_books_.end()) {
+    if (slot->book.load(std::memory_order_relaxed)) {
         return false; // Order book already exists
     }
 
-    auto instrument = instruments_[instrument_id];
-    auto book = std::make_shared<OrderBook>(instrument_id, instrument->primary_symbol);
-    book->set_config(config);
+    const auto& instrument = slot->instrument;
+
+    // Tick ladders are sized in the instrument's ticks unless told otherwise
+    OrderBook::Config book_config = config;
+    if (book_config.tick_size <= 0.0) {
+        book_config.tick_size = instrument->tick_size;
+    }
+    auto book = std::make_shared<OrderBook>(instrument_id, instrument->primary_symbol, book_config);
 
-    order_books_[instrument_id] = book;
+    const std::shared_ptr<OrderBook>* stored = book_storage_.push_back(book);
+    if (!stored) {
+        return false; // Book storage full
+    }
+
+    {
+        Shard& shard = shard_for(instrument_id);
+        std::lock_guard<std::mutex> shard_lock(shard.mutex);
+        shard.books.push_back(std::move(book));
+    }
+    slot->book.store(stored, std::memory_order_release);
+    book_count_.fetch_add(1, std::memory_order_relaxed);
     return true;
 }
 
 std::shared_ptr<OrderBook> OrderBookManager::get_order_book(uint32_t instrument_id) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    auto it = order_books_.find(instrument_id);
-    if (it != order_books_.end()) {
-        return it->second;
+    const InstrumentSlot* slot = slot_index_.find(instrument_id);
+    if (!slot) {
+        return nullptr;
     }
-    return nullptr;
+    const std::shared_ptr<OrderBook>* book = slot->book.load(std::memory_order_acquire);
+    return book ? *book : nullptr;
 }
 
 std::vector<std::shared_ptr<OrderBook>> OrderBookManager::get_all_order_books() const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-
     std::vector<std::shared_ptr<OrderBook>> result;
-    result.reserve(order_books_.size());
+    result.reserve(book_count());
 
-    for (const auto& [id, book] : order_books_) {
-        result.push_back(book);
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        result.insert(result.end(), shards_[i].books.begin(), shards_[i].books.end());
     }
 
     return result;
@@ -109,31 +138,66 @@ std::vector<std::shared_ptr<OrderBook>> OrderBookManager::get_all_order_books()
 std::pair<std::shared_ptr<Instrument>, std::shared_ptr<OrderBook>>
 OrderBookManager::get_instrument_and_book(uint32_t instrument_id) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    return { get_instrument(instrument_id), get_order_book(instrument_id) };
+}
 
-    auto instrument_it = instruments_.find(instrument_id);
-    auto book_it = order_books_.find(instrument_id);
+BookRef OrderBookManager::get_book_ref(uint32_t instrument_id) const
+{
+    const InstrumentSlot* slot = slot_index_.find(instrument_id);
+    if (!slot) {
+        return BookRef {};
+    }
 
-    std::shared_ptr<Instrument> instrument = (instrument_it != instruments_.end()) ? instrument_it->second : nullptr;
+    const std::shared_ptr<OrderBook>* book = slot->book.load(std::memory_order_acquire);
+    return BookRef { slot->instrument.get(), book ? book->get() : nullptr, slot->slot, &slot->runtime };
+}
 
-    std::shared_ptr<OrderBook> book = (book_it != order_books_.end()) ? book_it->second : nullptr;
+BookRef OrderBookManager::get_book_ref_by_slot(uint32_t slot_number) const
+{
+    if (slot_number >= slots_.size()) {
+        return BookRef {};
+    }
 
-    return { instrument, book };
+    const InstrumentSlot& slot = slots_[slot_number];
+    const std::shared_ptr<OrderBook>* book = slot.book.load(std::memory_order_acquire);
+    return BookRef { slot.instrument.get(), book ? book->get() : nullptr, slot_number, &slot.runtime };
 }
 
-void OrderBookManager::clear_all_books()
+uint32_t OrderBookManager::get_slot(uint32_t instrument_id) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    const InstrumentSlot* slot = slot_index_.find(instrument_id);
+    return slot ? slot->slot : NO_SLOT;
+}
+
+const InstrumentRuntime* OrderBookManager::get_runtime(uint32_t instrument_id) const
+{
+    const InstrumentSlot* slot = slot_index_.find(instrument_id);
+    return slot ? &slot->runtime : nullptr;
+}
 
-    for (auto& [id, book] : order_books_) {
-        book->clear();
+void OrderBookManager::clear_all_books()
+{
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+        std::lock_guard<std::mutex> lock(shards_[i].mutex);
+        for (auto& book : shards_[i].books) {
+            book->clear();
+        }
     }
 }
 
 void OrderBookManager::reset_all_books()
 {
-    std::lock_guard<std::mutex> lock(mutex_);
-    order_books_.clear();
+    std::lock_guard<std::mutex> lock(registry_mutex_);
+
+    size_t count = slots_.size();
+    for (size_t i = 0; i < count; ++i) {
+        slots_[i].book.store(nullptr, std::memory_order_release);
+    }
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+        std::lock_guard<std::mutex> shard_lock(shards_[i].mutex);
+        shards_[i].books.clear();
+    }
+    book_count_.store(0, std::memory_order_relaxed);
 }
 
 void OrderBookManager::apply_event(const std::shared_ptr<MarketEvent>& event)
@@ -142,30 +206,127 @@ void OrderBookManager::apply_event(const std::shared_ptr<MarketEvent>& event)
         return;
     }
 
-    std::lock_guard<std::mutex> lock(mutex_);
+    OrderBook* book = find_book(event->instrument_id);
+    if (!book) {
+        return;
+    }
+
+    Shard& shard = shard_for(event->instrument_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    book->apply_event(*event);
+}
 
-    auto book_it = order_books_.find(event->instrument_id);
-    if (book_it != order_books_.end()) {
-        book_it->second->apply_event(event);
+template <typename Get, typename Apply>
+size_t OrderBookManager::apply_batch(size_t count, Get get, Apply apply)
+{
+    // Lock every shard the batch touches, in index order so concurrent
+    // batches cannot deadlock, then apply in stream order
+    uint64_t touched = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (const auto* event = get(i)) {
+            touched |= uint64_t(1) << (event->instrument_id & shard_mask_);
+        }
     }
+
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+        if (touched & (uint64_t(1) << i)) {
+            shards_[i].mutex.lock();
+            shards_[i].batch_books.clear();
+        }
+    }
+
+    uint32_t last_id = 0;
+    OrderBook* book = nullptr;
+    bool resolved = false;
+    size_t applied = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        const auto* event = get(i);
+        if (!event) {
+            continue;
+        }
+
+        // Feeds usually repeat an instrument back to back, so only look up on a change
+        if (!resolved || event->instrument_id != last_id) {
+            book = find_book(event->instrument_id);
+            last_id = event->instrument_id;
+            resolved = true;
+            if (book && book->begin_batch()) {
+                shard_for(last_id).batch_books.push_back(book);
+            }
+        }
+
+        if (book) {
+            apply(*book, *event);
+            ++applied;
+        }
+    }
+
+    for (size_t i = 0; i <= shard_mask_; ++i) {
+        if (touched & (uint64_t(1) << i)) {
+            for (OrderBook* touched_book : shards_[i].batch_books) {
+                touched_book->end_batch();
+            }
+            shards_[i].mutex.unlock();
+        }
+    }
+    return applied;
+}
+
+size_t OrderBookManager::apply_events(const std::shared_ptr<MarketEvent>* events, size_t count)
+{
+    return apply_batch(
+        count,
+        [events](size_t i) { return events[i].get(); },
+        [](OrderBook& book, const MarketEvent& event) { book.apply_event(event); });
+}
+
+void OrderBookManager::apply_record(const MarketEventRecord& record)
+{
+    OrderBook* book = find_book(record.instrument_id);
+    if (!book) {
+        return;
+    }
+
+    Shard& shard = shard_for(record.instrument_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    book->apply_record(record);
+}
+
+size_t OrderBookManager::apply_records(const MarketEventRecord* records, size_t count)
+{
+    return apply_batch(
+        count,
+        [records](size_t i) { return &records[i]; },
+        [](OrderBook& book, const MarketEventRecord& record) { book.apply_record(record); });
 }
 
 std::shared_ptr<SnapshotEvent> OrderBookManager::create_snapshot(
     uint32_t instrument_id,
     size_t max_levels) const
 {
-    std::lock_guard<std::mutex> lock(mutex_);
+    OrderBook* book = find_book(instrument_id);
+    if (!book) {
+        return nullptr;
+    }
 
-    auto book_it = order_books_.find(instrument_id);
-    if (book_it != order_books_.end()) {
-        return book_it->second->create_snapshot_event(max_levels);
+    Shard& shard = shard_for(instrument_id);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return book->create_snapshot_event(max_levels);
+}
+
+std::optional<TopOfBook> OrderBookManager::get_top_of_book(uint32_t instrument_id) const
+{
+    const OrderBook* book = find_book(instrument_id);
+    if (!book) {
+        return std::nullopt;
     }
-    return nullptr;
+    return book->read_top_of_book();
 }
 
 bool OrderBookManager::validate_instrument(uint32_t instrument_id) const
 {
-    return instruments_.find(instrument_id) != instruments_.end();
+    return slot_index_.find(instrument_id) != nullptr;
 }
 
-} // namespace market_core
\ No newline at end of file
+} // namespace market_core
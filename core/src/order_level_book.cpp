@@ -0,0 +1,317 @@
+#include "../include/order_level_book.h"
+#include <algorithm>
+#include <cmath>
+
+namespace market_core {
+
+// SlotIndexMap implementation
+SlotIndexMap::SlotIndexMap(size_t initial_capacity)
+    : mask_(0)
+    , size_(0)
+{
+    size_t capacity = 16;
+    while (capacity < initial_capacity * 2) {
+        capacity <<= 1;
+    }
+    entries_.assign(capacity, Entry { EMPTY_KEY, 0 });
+    mask_ = capacity - 1;
+}
+
+uint32_t SlotIndexMap::find(uint64_t key) const
+{
+    for (size_t i = home(key);; i = (i + 1) & mask_) {
+        if (entries_[i].key == key) {
+            return entries_[i].value;
+        }
+        if (entries_[i].key == EMPTY_KEY) {
+            return npos;
+        }
+    }
+}
+
+void SlotIndexMap::insert(uint64_t key, uint32_t value)
+{
+    if ((size_ + 1) * 2 > entries_.size()) {
+        grow();
+    }
+
+    size_t i = home(key);
+    while (entries_[i].key != EMPTY_KEY) {
+        i = (i + 1) & mask_;
+    }
+    entries_[i] = Entry { key, value };
+    ++size_;
+}
+
+void SlotIndexMap::erase(uint64_t key)
+{
+    size_t i = home(key);
+    while (entries_[i].key != key) {
+        if (entries_[i].key == EMPTY_KEY) {
+            return;
+        }
+        i = (i + 1) & mask_;
+    }
+
+    // Shift later members of the probe run back into the hole
+    for (size_t j = (i + 1) & mask_; entries_[j].key != EMPTY_KEY; j = (j + 1) & mask_) {
+        size_t k = home(entries_[j].key);
+        bool movable = (i <= j) ? (k <= i || k > j) : (k <= i && k > j);
+        if (movable) {
+            entries_[i] = entries_[j];
+            i = j;
+        }
+    }
+    entries_[i].key = EMPTY_KEY;
+    --size_;
+}
+
+void SlotIndexMap::clear()
+{
+    std::fill(entries_.begin(), entries_.end(), Entry { EMPTY_KEY, 0 });
+    size_ = 0;
+}
+
+void SlotIndexMap::grow()
+{
+    std::vector<Entry> old_entries(entries_.size() * 2, Entry { EMPTY_KEY, 0 });
+    old_entries.swap(entries_);
+    mask_ = entries_.size() - 1;
+    size_ = 0;
+
+    for (const auto& entry : old_entries) {
+        if (entry.key != EMPTY_KEY) {
+            insert(entry.key, entry.value);
+        }
+    }
+}
+
+// OrderLevelBook implementation
+OrderLevelBook::OrderLevelBook(double tick_size, size_t initial_orders)
+    : tick_size_(tick_size)
+    , free_node_(NIL)
+    , free_level_(NIL)
+    , order_index_(initial_orders)
+    , level_index_(256)
+{
+    nodes_.reserve(initial_orders);
+    levels_.reserve(256);
+}
+
+bool OrderLevelBook::add(uint64_t order_id, Side side, double price, uint64_t quantity,
+    uint64_t timestamp_ns, LevelChange& change)
+{
+    if (order_index_.find(order_id) != SlotIndexMap::npos) {
+        return false;
+    }
+
+    uint32_t node = acquire_node();
+    nodes_[node].order = Order { order_id, side, price, quantity, timestamp_ns };
+    link_back(node);
+    order_index_.insert(order_id, node);
+
+    change = describe(nodes_[node].level, side, timestamp_ns);
+    return true;
+}
+
+size_t OrderLevelBook::modify(uint64_t order_id, double price, uint64_t quantity,
+    uint64_t timestamp_ns, LevelChange changes[2])
+{
+    uint32_t node = order_index_.find(order_id);
+    if (node == SlotIndexMap::npos) {
+        return 0;
+    }
+
+    if (quantity == 0) {
+        return cancel(order_id, changes[0]) ? 1 : 0;
+    }
+
+    Order& order = nodes_[node].order;
+    uint32_t level = nodes_[node].level;
+    bool same_level = level_key(order.side, price) == levels_[level].key;
+
+    if (same_level && quantity <= order.quantity) {
+        // Size reduction keeps time priority
+        levels_[level].quantity -= order.quantity - quantity;
+        order.quantity = quantity;
+        order.timestamp_ns = timestamp_ns;
+        changes[0] = describe(level, order.side, timestamp_ns);
+        return 1;
+    }
+
+    // Price change or size increase: requeue at the back
+    unlink(node);
+    size_t count = 0;
+    if (!same_level) {
+        changes[count++] = describe(level, order.side, timestamp_ns);
+    }
+
+    order.price = price;
+    order.quantity = quantity;
+    order.timestamp_ns = timestamp_ns;
+    link_back(node);
+    changes[count++] = describe(nodes_[node].level, order.side, timestamp_ns);
+    return count;
+}
+
+bool OrderLevelBook::cancel(uint64_t order_id, LevelChange& change)
+{
+    uint32_t node = order_index_.find(order_id);
+    if (node == SlotIndexMap::npos) {
+        return false;
+    }
+
+    uint32_t level = nodes_[node].level;
+    Side side = nodes_[node].order.side;
+    unlink(node);
+    change = describe(level, side, nodes_[node].order.timestamp_ns);
+
+    order_index_.erase(order_id);
+    release_node(node);
+    return true;
+}
+
+void OrderLevelBook::clear_side(Side side)
+{
+    for (uint32_t node = 0; node < nodes_.size(); ++node) {
+        if (nodes_[node].level != NIL && nodes_[node].order.side == side) {
+            uint64_t order_id = nodes_[node].order.order_id;
+            unlink(node);
+            order_index_.erase(order_id);
+            release_node(node);
+        }
+    }
+}
+
+void OrderLevelBook::clear()
+{
+    nodes_.clear();
+    levels_.clear();
+    free_node_ = NIL;
+    free_level_ = NIL;
+    order_index_.clear();
+    level_index_.clear();
+}
+
+const Order* OrderLevelBook::find(uint64_t order_id) const
+{
+    uint32_t node = order_index_.find(order_id);
+    return node == SlotIndexMap::npos ? nullptr : &nodes_[node].order;
+}
+
+size_t OrderLevelBook::queue_position(uint64_t order_id) const
+{
+    uint32_t node = order_index_.find(order_id);
+    if (node == SlotIndexMap::npos) {
+        return 0;
+    }
+
+    size_t position = 1;
+    for (uint32_t prev = nodes_[node].prev; prev != NIL; prev = nodes_[prev].prev) {
+        ++position;
+    }
+    return position;
+}
+
+uint64_t OrderLevelBook::front_order_id(Side side, double price) const
+{
+    uint32_t level = level_index_.find(level_key(side, price));
+    if (level == SlotIndexMap::npos) {
+        return 0;
+    }
+    return nodes_[levels_[level].head].order.order_id;
+}
+
+uint64_t OrderLevelBook::level_key(Side side, double price) const
+{
+    double resolution = tick_size_ > 0.0 ? tick_size_ : 1e-9;
+    uint64_t tick = static_cast<uint64_t>(std::llround(price / resolution));
+    return (tick << 1) | (side == Side::ASK ? 1 : 0);
+}
+
+uint32_t OrderLevelBook::acquire_node()
+{
+    if (free_node_ != NIL) {
+        uint32_t node = free_node_;
+        free_node_ = nodes_[node].next;
+        return node;
+    }
+
+    nodes_.push_back(OrderNode {});
+    return static_cast<uint32_t>(nodes_.size() - 1);
+}
+
+void OrderLevelBook::release_node(uint32_t node)
+{
+    nodes_[node].level = NIL;
+    nodes_[node].prev = NIL;
+    nodes_[node].next = free_node_;
+    free_node_ = node;
+}
+
+void OrderLevelBook::link_back(uint32_t node)
+{
+    const Order& order = nodes_[node].order;
+    uint64_t key = level_key(order.side, order.price);
+
+    uint32_t level = level_index_.find(key);
+    if (level == SlotIndexMap::npos) {
+        if (free_level_ != NIL) {
+            level = free_level_;
+            free_level_ = levels_[level].next_free;
+        } else {
+            levels_.push_back(LevelQueue {});
+            level = static_cast<uint32_t>(levels_.size() - 1);
+        }
+        levels_[level] = LevelQueue { NIL, NIL, 0, 0, order.price, key, NIL };
+        level_index_.insert(key, level);
+    }
+
+    LevelQueue& queue = levels_[level];
+    nodes_[node].level = level;
+    nodes_[node].prev = queue.tail;
+    nodes_[node].next = NIL;
+    if (queue.tail != NIL) {
+        nodes_[queue.tail].next = node;
+    } else {
+        queue.head = node;
+    }
+    queue.tail = node;
+    queue.order_count++;
+    queue.quantity += order.quantity;
+}
+
+void OrderLevelBook::unlink(uint32_t node)
+{
+    OrderNode& entry = nodes_[node];
+    LevelQueue& queue = levels_[entry.level];
+
+    if (entry.prev != NIL) {
+        nodes_[entry.prev].next = entry.next;
+    } else {
+        queue.head = entry.next;
+    }
+    if (entry.next != NIL) {
+        nodes_[entry.next].prev = entry.prev;
+    } else {
+        queue.tail = entry.prev;
+    }
+
+    queue.order_count--;
+    queue.quantity -= entry.order.quantity;
+
+    if (queue.order_count == 0) {
+        // Level is empty: release it, its counters stay readable until reuse
+        level_index_.erase(queue.key);
+        queue.next_free = free_level_;
+        free_level_ = entry.level;
+    }
+}
+
+OrderLevelBook::LevelChange OrderLevelBook::describe(uint32_t level, Side side, uint64_t timestamp_ns) const
+{
+    const LevelQueue& queue = levels_[level];
+    return LevelChange { side, queue.price, queue.quantity, queue.order_count, timestamp_ns };
+}
+
+} // namespace market_core
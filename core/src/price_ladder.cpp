@@ -0,0 +1,145 @@
+#include "../include/price_ladder.h"
+#include <cmath>
+
+namespace market_core {
+
+PriceLadder::PriceLadder(Side side, double tick_size, size_t window_ticks)
+    : side_(side)
+    , tick_size_(tick_size)
+    , base_tick_(0)
+    , slots_(window_ticks > 0 ? window_ticks : 1)
+    , occupied_(slots_.size())
+    , count_(0)
+    , best_index_(-1)
+    , dropped_levels_(0)
+{
+}
+
+void PriceLadder::set(const PriceLevel& level)
+{
+    int64_t tick = to_tick(level.price);
+    int64_t window = static_cast<int64_t>(slots_.size());
+
+    if (count_ == 0) {
+        // Empty ladder: centre the window on the first price we see
+        base_tick_ = tick - window / 2;
+    } else if (tick < base_tick_ || tick >= base_tick_ + window) {
+        recentre(tick);
+    }
+
+    int64_t index = tick - base_tick_;
+    if (index < 0 || index >= window) {
+        // Too deep to fit next to the current best
+        ++dropped_levels_;
+        return;
+    }
+
+    size_t slot = static_cast<size_t>(index);
+    slots_[slot] = level;
+    if (!occupied_.test(slot)) {
+        occupied_.set(slot);
+        ++count_;
+    }
+
+    if (best_index_ < 0 || is_better(index, best_index_)) {
+        best_index_ = index;
+    }
+}
+
+void PriceLadder::erase(double price)
+{
+    int64_t index = to_tick(price) - base_tick_;
+    if (index < 0 || index >= static_cast<int64_t>(slots_.size())) {
+        return;
+    }
+
+    size_t slot = static_cast<size_t>(index);
+    if (!occupied_.test(slot)) {
+        return;
+    }
+
+    occupied_.reset(slot);
+    --count_;
+
+    if (index == best_index_) {
+        find_best_from(index);
+    }
+}
+
+void PriceLadder::clear()
+{
+    occupied_.clear();
+    count_ = 0;
+    best_index_ = -1;
+}
+
+int64_t PriceLadder::to_tick(double price) const
+{
+    return std::llround(price / tick_size_);
+}
+
+bool PriceLadder::is_better(int64_t index, int64_t other) const
+{
+    return side_ == Side::BID ? index > other : index < other;
+}
+
+void PriceLadder::recentre(int64_t tick)
+{
+    // Centre on whichever of the current best and the incoming tick is better,
+    // so the touch always keeps half a window of room on each side
+    int64_t best_tick = base_tick_ + best_index_;
+    int64_t anchor = is_better(tick - base_tick_, best_index_) ? tick : best_tick;
+
+    int64_t window = static_cast<int64_t>(slots_.size());
+    int64_t shift = (anchor - window / 2) - base_tick_;
+    if (shift == 0) {
+        return;
+    }
+
+    if (shift >= window || -shift >= window) {
+        dropped_levels_ += count_;
+        clear();
+    } else if (shift > 0) {
+        // Window moves up: walk occupied slots upwards so moves never overwrite
+        for (size_t i = occupied_.find_first(); i != OccupancyBitmap::npos; i = occupied_.find_next(i + 1)) {
+            occupied_.reset(i);
+            int64_t target = static_cast<int64_t>(i) - shift;
+            if (target < 0) {
+                ++dropped_levels_;
+                --count_;
+                continue;
+            }
+            slots_[static_cast<size_t>(target)] = slots_[i];
+            occupied_.set(static_cast<size_t>(target));
+        }
+    } else {
+        // Window moves down: walk occupied slots downwards
+        for (size_t i = occupied_.find_last(); i != OccupancyBitmap::npos; i = (i == 0) ? OccupancyBitmap::npos : occupied_.find_prev(i - 1)) {
+            occupied_.reset(i);
+            int64_t target = static_cast<int64_t>(i) - shift;
+            if (target >= window) {
+                ++dropped_levels_;
+                --count_;
+                continue;
+            }
+            slots_[static_cast<size_t>(target)] = slots_[i];
+            occupied_.set(static_cast<size_t>(target));
+        }
+    }
+
+    base_tick_ += shift;
+    find_best_from(side_ == Side::BID ? window - 1 : 0);
+}
+
+void PriceLadder::find_best_from(int64_t index)
+{
+    size_t found = OccupancyBitmap::npos;
+    if (side_ == Side::BID) {
+        found = (index < 0) ? OccupancyBitmap::npos : occupied_.find_prev(static_cast<size_t>(index));
+    } else {
+        found = occupied_.find_next(static_cast<size_t>(index));
+    }
+    best_index_ = (found == OccupancyBitmap::npos) ? -1 : static_cast<int64_t>(found);
+}
+
+} // namespace market_core
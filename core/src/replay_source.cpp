@@ -0,0 +1,135 @@
+#include "../include/replay_source.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace market_core {
+
+ReplaySource::ReplaySource(std::shared_ptr<OrderBookManager> book_manager, double speed)
+    : book_manager_(std::move(book_manager))
+    , speed_(std::max(0.0, speed))
+{
+}
+
+bool ReplaySource::open(const std::string& path, std::string& error)
+{
+    started_ = false;
+    next_ = 0;
+    return capture_.open(path, error);
+}
+
+void ReplaySource::start()
+{
+    started_ = true;
+    start_ticks_ = TscClock::now();
+    last_ticks_ = start_ticks_;
+    first_timestamp_ns_ = capture_.empty() ? 0 : capture_.records()[0].timestamp_ns;
+    ticks_per_record_ns_ = speed_ > 0.0 ? TscClock::ticks_per_ns() / speed_ : 0.0;
+    next_ = 0;
+    lag_sum_ticks_ = 0.0;
+    max_lag_ticks_ = 0;
+}
+
+void ReplaySource::send(const MarketEventRecord* records, size_t count)
+{
+    // Same order as the generator: books first, then protocol adapters
+    book_manager_->apply_records(records, count);
+    for (const auto& listener : listeners_) {
+        listener->on_market_events(records, count);
+    }
+}
+
+size_t ReplaySource::run_until(uint64_t deadline)
+{
+    if (!started_) {
+        start();
+    }
+
+    const MarketEventRecord* records = capture_.records();
+    const size_t total = capture_.size();
+    size_t sent = 0;
+
+    while (next_ < total) {
+        uint64_t now = TscClock::now();
+        last_ticks_ = now;
+
+        size_t end = next_;
+        if (speed_ <= 0.0) {
+            end = std::min(total, next_ + BLOCK_RECORDS);
+        } else {
+            // Everything already due goes out as one block
+            double elapsed = static_cast<double>(now - start_ticks_);
+            while (end < total && end - next_ < BLOCK_RECORDS) {
+                uint64_t timestamp = records[end].timestamp_ns;
+                double due = timestamp > first_timestamp_ns_
+                    ? static_cast<double>(timestamp - first_timestamp_ns_) * ticks_per_record_ns_
+                    : 0.0;
+                if (due > elapsed) {
+                    break;
+                }
+                auto lag = static_cast<uint64_t>(elapsed - due);
+                lag_sum_ticks_ += static_cast<double>(lag);
+                max_lag_ticks_ = std::max(max_lag_ticks_, lag);
+                ++end;
+            }
+        }
+
+        if (end > next_) {
+            send(records + next_, end - next_);
+            sent += end - next_;
+            next_ = end;
+            if (now >= deadline) {
+                break;
+            }
+            continue;
+        }
+
+        if (now >= deadline) {
+            break;
+        }
+        TscClock::pause();
+    }
+    return sent;
+}
+
+ReplaySource::Report ReplaySource::report() const
+{
+    Report report;
+    report.replayed = next_;
+    report.total = capture_.size();
+    if (!capture_.empty()) {
+        uint64_t last = capture_.records()[capture_.size() - 1].timestamp_ns;
+        report.recorded_seconds = last > first_timestamp_ns_ ? static_cast<double>(last - first_timestamp_ns_) / 1e9 : 0.0;
+    }
+
+    report.elapsed_seconds = TscClock::to_ns(last_ticks_ - start_ticks_) / 1e9;
+    if (report.elapsed_seconds > 0.0) {
+        report.achieved_rate = static_cast<double>(next_) / report.elapsed_seconds;
+    }
+    if (next_ > 0 && speed_ > 0.0) {
+        report.mean_lag_ns = TscClock::to_ns(static_cast<uint64_t>(lag_sum_ticks_ / static_cast<double>(next_)));
+    }
+    report.max_lag_ns = TscClock::to_ns(max_lag_ticks_);
+    return report;
+}
+
+bool ReplaySource::parse_speed(const std::string& text, double& speed)
+{
+    if (text == "max") {
+        speed = 0.0;
+        return true;
+    }
+    try {
+        size_t used = 0;
+        double value = std::stod(text, &used);
+        // Allow "10x"
+        if (value < 0.0 || (used != text.size() && text.substr(used) != "x")) {
+            return false;
+        }
+        speed = value;
+        return true;
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+} // namespace market_core
@@ -0,0 +1,228 @@
+#include "../include/scenario.h"
+#include <algorithm>
+#include <cctype>
+#include <sstream>
+
+namespace market_core {
+
+// Lower case, single spaces: "Channel  2" and "channel 2" are one group
+static std::string normalize_group(const std::string& name)
+{
+    std::istringstream words(name);
+    std::string word;
+    std::string result;
+    while (words >> word) {
+        std::transform(word.begin(), word.end(), word.begin(), [](unsigned char c) { return std::tolower(c); });
+        if (!result.empty()) {
+            result += ' ';
+        }
+        result += word;
+    }
+    return result;
+}
+
+static bool parse_duration(const std::string& text, uint64_t& duration_ns)
+{
+    size_t used = 0;
+    double value = 0.0;
+    try {
+        value = std::stod(text, &used);
+    } catch (const std::exception&) {
+        return false;
+    }
+    std::string unit = text.substr(used);
+    double scale = 0.0;
+    if (unit == "ms") {
+        scale = 1e6;
+    } else if (unit == "s") {
+        scale = 1e9;
+    } else if (unit == "m") {
+        scale = 60e9;
+    }
+    if (scale == 0.0 || value <= 0.0) {
+        return false;
+    }
+    duration_ns = static_cast<uint64_t>(value * scale);
+    return true;
+}
+
+bool parse_scenario(const std::string& text, std::vector<ScenarioPhase>& phases, std::string& error)
+{
+    std::vector<ScenarioPhase> result;
+    std::istringstream steps(text);
+    std::string step;
+    while (std::getline(steps, step, ',')) {
+        std::istringstream words(step);
+        std::string mode_name;
+        std::string duration;
+        if (!(words >> mode_name >> duration)) {
+            error = "expected \"MODE DURATION [on GROUP]\" in \"" + step + "\"";
+            return false;
+        }
+
+        ScenarioPhase phase;
+        if (!MarketDataGenerator::parse_market_mode(mode_name, phase.mode)) {
+            error = "unknown market mode " + mode_name;
+            return false;
+        }
+        if (!parse_duration(duration, phase.duration_ns)) {
+            error = "bad duration " + duration + " (use ms, s or m)";
+            return false;
+        }
+
+        std::string on;
+        if (words >> on) {
+            std::string rest;
+            std::getline(words, rest);
+            phase.group = normalize_group(rest);
+            if (normalize_group(on) != "on" || phase.group.empty()) {
+                error = "expected \"on GROUP\" after " + duration;
+                return false;
+            }
+            if (phase.group == "all") {
+                phase.group.clear();
+            }
+        }
+        result.push_back(phase);
+    }
+
+    if (result.empty()) {
+        error = "empty scenario";
+        return false;
+    }
+    phases = std::move(result);
+    return true;
+}
+
+static double mode_rate(MarketMode mode)
+{
+    MarketConfig config;
+    MarketDataGenerator::apply_mode_preset(mode, config);
+    return static_cast<double>(config.updates_per_second);
+}
+
+ScenarioRunner::ScenarioRunner(MarketDataGenerator& generator, std::vector<ScenarioPhase> phases, Groups groups,
+    LoadGenerator* load)
+    : generator_(generator)
+    , phases_(std::move(phases))
+    , load_(load)
+    , instrument_count_(load ? load->instrument_count() : 0)
+{
+    for (auto& entry : groups) {
+        groups_[normalize_group(entry.first)] = std::move(entry.second);
+    }
+    for (auto& phase : phases_) {
+        phase.group = normalize_group(phase.group);
+    }
+    reports_.reserve(phases_.size());
+}
+
+bool ScenarioRunner::validate(std::string& error) const
+{
+    for (const auto& phase : phases_) {
+        if (!phase.group.empty() && groups_.find(phase.group) == groups_.end()) {
+            error = "unknown instrument group \"" + phase.group + "\"";
+            return false;
+        }
+    }
+    return true;
+}
+
+void ScenarioRunner::start()
+{
+    started_ = true;
+    current_ = 0;
+    reports_.clear();
+    global_mode_ = generator_.get_config().mode;
+    if (!phases_.empty()) {
+        enter_phase(TscClock::now());
+    }
+}
+
+bool ScenarioRunner::update(uint64_t now)
+{
+    if (!started_) {
+        start();
+    }
+    while (current_ < phases_.size() && now >= phase_end_ticks_) {
+        // Phases start back to back on the schedule, not when noticed
+        uint64_t boundary = phase_end_ticks_;
+        close_phase(boundary);
+        ++current_;
+        if (current_ < phases_.size()) {
+            enter_phase(boundary);
+        }
+    }
+    return current_ < phases_.size();
+}
+
+void ScenarioRunner::stop()
+{
+    if (started_ && current_ < phases_.size()) {
+        close_phase(TscClock::now());
+        current_ = phases_.size();
+    }
+}
+
+void ScenarioRunner::enter_phase(uint64_t now)
+{
+    const ScenarioPhase& phase = phases_[current_];
+    phase_start_ticks_ = now;
+    phase_end_ticks_ = now + TscClock::from_ns(static_cast<double>(phase.duration_ns));
+
+    generator_.clear_instrument_modes();
+    double rate = mode_rate(phase.mode);
+    if (phase.group.empty()) {
+        global_mode_ = phase.mode;
+        generator_.set_market_mode(phase.mode);
+    } else {
+        const auto& members = groups_[phase.group];
+        generator_.set_instrument_mode(members, phase.mode);
+        if (instrument_count_ > 0) {
+            double share = std::min(1.0, static_cast<double>(members.size()) / static_cast<double>(instrument_count_));
+            rate = share * rate + (1.0 - share) * mode_rate(global_mode_);
+        }
+    }
+
+    rate_scale_ = rate / mode_rate(MarketMode::NORMAL);
+    stats_start_ = generator_.get_statistics();
+    if (load_) {
+        load_->set_rate_scale(rate_scale_);
+        lag_start_ = load_->lag_histogram();
+        service_start_ = load_->service_histogram();
+    }
+}
+
+void ScenarioRunner::close_phase(uint64_t now)
+{
+    PhaseReport report;
+    report.phase = phases_[current_];
+    report.elapsed_seconds = TscClock::to_ns(now - phase_start_ticks_) / 1e9;
+    report.rate_scale = rate_scale_;
+
+    const auto& stats = generator_.get_statistics();
+    report.updates = stats.updates_generated - stats_start_.updates_generated;
+    report.trades = stats.trades_generated - stats_start_.trades_generated;
+    if (report.elapsed_seconds > 0.0) {
+        report.update_rate = static_cast<double>(report.updates) / report.elapsed_seconds;
+    }
+
+    if (load_) {
+        report.target_rate = load_->profile().mean_rate() * rate_scale_;
+        report.lag_ns = load_->lag_histogram().since(lag_start_);
+        report.service_ns = load_->service_histogram().since(service_start_);
+    }
+    reports_.push_back(report);
+}
+
+std::string ScenarioRunner::describe(const ScenarioPhase& phase)
+{
+    std::ostringstream text;
+    text << MarketDataGenerator::market_mode_name(phase.mode) << " " << phase.duration_ns / 1000000 << "ms";
+    if (!phase.group.empty()) {
+        text << " on " << phase.group;
+    }
+    return text.str();
+}
+
+} // namespace market_core
@@ -0,0 +1,134 @@
+#include "../include/synthetic_universe.h"
+#include "../include/philox.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace market_core {
+
+struct FxPairTemplate {
+    const char* symbol;
+    const char* base;
+    const char* quote;
+    double price;
+};
+
+struct FutureTemplate {
+    const char* root;
+    double tick_size;
+    double price;
+    double contract_size;
+};
+
+static const FxPairTemplate FX_PAIRS[] = {
+    { "EURUSD", "EUR", "USD", 1.0850 },
+    { "GBPUSD", "GBP", "USD", 1.2650 },
+    { "USDJPY", "USD", "JPY", 149.50 },
+    { "USDCHF", "USD", "CHF", 0.8950 },
+    { "AUDUSD", "AUD", "USD", 0.6680 },
+    { "NZDUSD", "NZD", "USD", 0.6020 },
+    { "USDCAD", "USD", "CAD", 1.3620 },
+    { "EURGBP", "EUR", "GBP", 0.8580 },
+    { "EURJPY", "EUR", "JPY", 162.20 },
+    { "GBPJPY", "GBP", "JPY", 189.10 },
+    { "EURCHF", "EUR", "CHF", 0.9710 },
+    { "AUDJPY", "AUD", "JPY", 99.85 },
+    { "USDSEK", "USD", "SEK", 10.4500 },
+    { "USDNOK", "USD", "NOK", 10.6200 },
+};
+
+static const char* const FORWARD_TENORS[] = { "1W", "1M", "3M", "6M", "1Y" };
+static const double FORWARD_YEARS[] = { 7.0 / 365.0, 1.0 / 12.0, 0.25, 0.5, 1.0 };
+
+static const FutureTemplate FUTURES[] = {
+    { "ES", 0.25, 5000.0, 50.0 },
+    { "NQ", 0.25, 17500.0, 20.0 },
+    { "CL", 0.01, 78.00, 1000.0 },
+    { "GC", 0.10, 2000.0, 100.0 },
+    { "ZN", 0.015625, 110.0, 1000.0 },
+    { "6E", 0.00005, 1.0900, 125000.0 },
+};
+
+static const char FUTURE_MONTH_CODES[] = { 'H', 'M', 'U', 'Z' };
+
+static double round_to_tick(double price, double tick_size)
+{
+    return std::max(tick_size, std::round(price / tick_size) * tick_size);
+}
+
+static double fx_tick_size(const FxPairTemplate& pair)
+{
+    return std::string(pair.quote) == "JPY" ? 0.001 : 0.00001;
+}
+
+std::vector<std::shared_ptr<Instrument>> generate_universe(const UniverseSpec& spec)
+{
+    constexpr size_t PAIR_COUNT = sizeof(FX_PAIRS) / sizeof(FX_PAIRS[0]);
+    constexpr size_t TENOR_COUNT = sizeof(FORWARD_TENORS) / sizeof(FORWARD_TENORS[0]);
+    constexpr size_t FUTURE_COUNT = sizeof(FUTURES) / sizeof(FUTURES[0]);
+
+    std::vector<std::shared_ptr<Instrument>> universe;
+    universe.reserve(spec.count);
+
+    double spot_share = std::min(1.0, std::max(0.0, spec.fx_spot_share));
+    double forward_share = std::min(1.0 - spot_share, std::max(0.0, spec.fx_forward_share));
+    auto spot_count = static_cast<size_t>(static_cast<double>(spec.count) * spot_share);
+    auto forward_count = static_cast<size_t>(static_cast<double>(spec.count) * forward_share);
+
+    CounterRng rng(spec.seed, 0, 0);
+
+    for (size_t i = 0; i < spec.count; ++i) {
+        auto id = static_cast<uint32_t>(spec.first_id + i);
+        std::string suffix = "." + std::to_string(i);
+        // Each copy of a product sits within +/-5% of the template price
+        double jitter = 1.0 + (rng.uniform() - 0.5) * 0.1;
+
+        std::shared_ptr<Instrument> instrument;
+        double price = 0.0;
+        int spread_ticks = 2 + static_cast<int>(rng.uniform() * 2.0);
+
+        if (i < spot_count) {
+            const FxPairTemplate& pair = FX_PAIRS[i % PAIR_COUNT];
+            auto spot = std::make_shared<FXSpotInstrument>(id, pair.symbol + suffix);
+            spot->base_currency = pair.base;
+            spot->quote_currency = pair.quote;
+            spot->settlement_convention = std::string(pair.symbol) == "USDCAD" ? "T+1" : "T+2";
+            spot->tick_size = fx_tick_size(pair);
+            price = pair.price * jitter;
+            instrument = spot;
+        } else if (i < spot_count + forward_count) {
+            size_t n = i - spot_count;
+            const FxPairTemplate& pair = FX_PAIRS[n % PAIR_COUNT];
+            size_t tenor = (n / PAIR_COUNT) % TENOR_COUNT;
+            instrument = std::make_shared<Instrument>(
+                id, std::string(pair.symbol) + "." + FORWARD_TENORS[tenor] + suffix, InstrumentType::FX_FORWARD);
+            instrument->tick_size = fx_tick_size(pair);
+            instrument->set_property("tenor", std::string(FORWARD_TENORS[tenor]));
+            // Forward points from a flat 2% rate differential
+            price = pair.price * jitter * (1.0 + 0.02 * FORWARD_YEARS[tenor]);
+        } else {
+            size_t n = i - spot_count - forward_count;
+            const FutureTemplate& product = FUTURES[n % FUTURE_COUNT];
+            size_t expiry = (n / FUTURE_COUNT) % (sizeof(FUTURE_MONTH_CODES) * 2);
+            std::string contract_month = std::string(1, FUTURE_MONTH_CODES[expiry % 4]) + std::to_string(6 + expiry / 4);
+            auto future = std::make_shared<FuturesInstrument>(id, product.root + contract_month + suffix);
+            future->underlying = product.root;
+            future->contract_month = contract_month;
+            future->contract_size = product.contract_size;
+            future->multiplier = product.contract_size;
+            future->tick_size = product.tick_size;
+            price = product.price * jitter;
+            instrument = future;
+        }
+
+        instrument->min_price_increment = instrument->tick_size;
+        price = round_to_tick(price, instrument->tick_size);
+        instrument->set_property("initial_price", price);
+        instrument->set_property("initial_spread", instrument->tick_size * spread_ticks);
+        universe.push_back(std::move(instrument));
+    }
+
+    return universe;
+}
+
+} // namespace market_core
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace protocol_common {
+
+// Minimal JSON document model for configuration files.
+//
+// parse() accepts RFC 8259 JSON (objects, arrays, strings with escapes,
+// numbers, true/false/null) and throws std::runtime_error with the byte
+// offset on malformed input. Accessors never throw: a missing member or a
+// value of the wrong type yields the supplied fallback.
+class JsonValue {
+public:
+    enum class Type {
+        NUL,
+        BOOLEAN,
+        NUMBER,
+        STRING,
+        ARRAY,
+        OBJECT
+    };
+
+    static JsonValue parse(const std::string& text);
+
+    Type type() const { return type_; }
+    bool is_object() const { return type_ == Type::OBJECT; }
+    bool is_array() const { return type_ == Type::ARRAY; }
+
+    // Object member, nullptr if absent or not an object
+    const JsonValue* find(const std::string& key) const;
+
+    // Array elements, empty if not an array
+    const std::vector<JsonValue>& items() const { return items_; }
+
+    // Object members in document order, empty if not an object
+    const std::vector<std::pair<std::string, JsonValue>>& members() const { return members_; }
+
+    double as_number(double fallback = 0.0) const { return type_ == Type::NUMBER ? number_ : fallback; }
+    bool as_bool(bool fallback = false) const { return type_ == Type::BOOLEAN ? bool_ : fallback; }
+    std::string as_string(const std::string& fallback = "") const { return type_ == Type::STRING ? string_ : fallback; }
+
+    // Member shortcuts for objects
+    double number(const std::string& key, double fallback) const;
+    bool boolean(const std::string& key, bool fallback) const;
+    std::string string(const std::string& key, const std::string& fallback) const;
+
+private:
+    friend class JsonParser;
+
+    Type type_ = Type::NUL;
+    bool bool_ = false;
+    double number_ = 0.0;
+    std::string string_;
+    std::vector<JsonValue> items_;
+    std::vector<std::pair<std::string, JsonValue>> members_;
+};
+
+} // namespace protocol_common
@@ -3,6 +3,7 @@
 #include <cstdint>
 #include <netinet/in.h>
 #include <string>
+#include <utility>
 #include <vector>
 
 namespace protocol_common {
@@ -37,7 +38,7 @@ public:
 
     // Status
     bool is_valid() const { return socket_fd_ >= 0; }
-    std::string get_last_error() const { return last_error_; }
+    std::string get_last_error() const;
 
     // Close socket
     void close();
@@ -51,6 +52,21 @@ private:
     bool is_sender_;
     std::string last_error_;
 
+    // send() runs once per packet, so its failures are recorded as plain
+    // values and only turned into text by get_last_error()
+    enum class SendFailure { NONE, NOT_SENDER, SEND_FAILED, PARTIAL };
+    SendFailure send_failure_ = SendFailure::NONE;
+    int send_errno_ = 0;
+    size_t send_sent_ = 0;
+    size_t send_length_ = 0;
+
+    // Newer than any recorded send failure, which it replaces
+    void set_error(std::string error)
+    {
+        last_error_ = std::move(error);
+        send_failure_ = SendFailure::NONE;
+    }
+
     bool join_multicast_group();
     bool set_multicast_interface();
 };
@@ -1,7 +1,9 @@
 #pragma once
 
 #include "instrument.h"
+#include "market_event_record.h"
 #include "market_events.h"
+#include "price_level.h"
 #include "reuters_messages.h"
 #include <chrono>
 #include <string>
@@ -9,6 +11,25 @@
 
 namespace reuters_protocol {
 
+// Book levels for a snapshot, best first on each side. The encoder only
+// reads them, so any level storage the caller keeps can back a view.
+struct SnapshotBookView {
+    uint32_t instrument_id = 0;
+    uint64_t rpt_seq = 0;
+    uint64_t transact_time = 0;
+    uint64_t last_msg_seq_num_processed = 0; // Incremental sequence the book reflects
+    const market_core::PriceLevel* bids = nullptr;
+    size_t bid_count = 0;
+    const market_core::PriceLevel* asks = nullptr;
+    size_t ask_count = 0;
+
+    size_t entry_count() const { return bid_count + ask_count; }
+};
+
+// SBE encoders for the UTP feed. Every message has two forms: one returns
+// a new vector, the other writes at buffer + offset (capacity is the size
+// of the whole buffer) and returns the encoded length, or 0 if the message
+// does not fit. The buffer forms never allocate.
 class ReutersEncoder {
 public:
     static constexpr size_t MAX_MESSAGE_SIZE = 65536; // 64KB - much larger buffer
@@ -43,13 +64,34 @@ public:
         const std::string& reason);
 
     static std::vector<uint8_t> encode_heartbeat();
+    static size_t encode_heartbeat(uint8_t* buffer, size_t offset, size_t capacity);
 
     // Market Data Messages
     static std::vector<uint8_t> encode_security_definition(
         const market_core::Instrument& instrument);
+    static size_t encode_security_definition(
+        const market_core::Instrument& instrument, uint8_t* buffer, size_t offset, size_t capacity);
+
+    // Hash of every field encode_security_definition writes but
+    // lastUpdateTime, so a cached definition is re-encoded only when one of
+    // them changes and keeps the time of that change. Keep the two in step.
+    static uint64_t security_definition_fingerprint(const market_core::Instrument& instrument);
 
     static std::vector<uint8_t> encode_market_data_snapshot(
         const market_core::SnapshotEvent& snapshot);
+    static size_t encode_market_data_snapshot(
+        const market_core::SnapshotEvent& snapshot, uint8_t* buffer, size_t offset, size_t capacity);
+
+    // One fragment of a snapshot: entries [first, first + count) of the
+    // book, bids before asks. Every fragment carries the same securityID,
+    // rptSeq, transactTime and lastMsgSeqNumProcessed, so a receiver joins
+    // consecutive fragments with equal securityID and rptSeq; marketDepth is
+    // the deeper side of the whole book (at most 255).
+    static size_t encode_market_data_snapshot(const SnapshotBookView& book, size_t first, size_t count,
+        uint8_t* buffer, size_t offset, size_t capacity);
+
+    // Most book entries a snapshot fragment of max_length bytes can carry
+    static size_t snapshot_fragment_entries(size_t max_length);
 
     static std::vector<uint8_t> encode_market_data_incremental(
         const market_core::QuoteEvent& quote);
@@ -57,6 +99,23 @@ public:
     static std::vector<uint8_t> encode_market_data_incremental(
         const market_core::TradeEvent& trade);
 
+    // QUOTE_UPDATE or TRADE record; empty (0) for any other type
+    static std::vector<uint8_t> encode_market_data_incremental(
+        const market_core::MarketEventRecord& record);
+    static size_t encode_market_data_incremental(
+        const market_core::MarketEventRecord& record, uint8_t* buffer, size_t offset, size_t capacity);
+
+    // Several updates of one instrument and type as one message with an
+    // entry each, in order. Quotes get the first record's rptSeq, so entry i
+    // stands for rptSeq + i; callers only batch consecutive sequence numbers.
+    // 0 if the records are mixed or do not fit.
+    static size_t encode_market_data_incremental(const market_core::MarketEventRecord* const* records,
+        size_t count, uint8_t* buffer, size_t offset, size_t capacity);
+
+    // Most updates of type (QUOTE_UPDATE or TRADE) one incremental message
+    // of max_length bytes can carry; 0 for other types
+    static size_t incremental_message_entries(market_core::MarketEvent::EventType type, size_t max_length);
+
     // Market Data Request Response
     static std::vector<uint8_t> encode_market_data_request_rejection(
         const std::string& md_req_id,
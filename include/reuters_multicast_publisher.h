@@ -1,7 +1,9 @@
 #pragma once
 
 #include "common/udp_multicast_transport.h"
+#include "market_event_record.h"
 #include "market_events.h"
+#include "order_book.h"
 #include "reuters_encoder.h"
 #include <atomic>
 #include <chrono>
@@ -21,6 +23,7 @@ struct MulticastChannelConfig {
     int channel_id;
     std::string description;
     std::vector<std::string> instruments; // Instruments on this channel
+    std::vector<uint32_t> instrument_ids; // Same, resolved by the config loader
 };
 
 // Configuration for Reuters multicast feeds
@@ -43,15 +46,39 @@ struct ReutersMulticastConfig {
     uint32_t incremental_interval_ms = 10;
     uint32_t snapshot_interval_seconds = 60;
     uint32_t heartbeat_interval_seconds = 30;
+    uint32_t security_definition_interval_seconds = 10; // Rebroadcast cycle; 0 = no rebroadcast
     uint32_t conflation_interval_ms = 0; // 0 = no conflation
+    uint32_t batch_window_us = 0; // Collect incrementals per instrument this long; 0 = send each at once
+    uint32_t packet_mtu = 0; // Pack messages into packets of up to this many bytes; 0 = one message per packet
+    uint32_t packet_max_latency_us = 20; // Longest a packed message waits for the packet to fill
 
     // Book parameters
     uint32_t book_depth = 10;
     bool send_statistics = true;
 };
 
+// Publishes UTP market data over UDP multicast. Every packet is a Thomson
+// Reuters Binary Packet Header followed by SBE messages; both are written
+// in place into a packet buffer owned by the channel's route, so publishing
+// an incremental update allocates nothing between the event and sendto.
+//
+// With packet_mtu set, a channel's incrementals and heartbeats share a
+// packet until the next message would not fit or the oldest one has waited
+// packet_max_latency_us. The timer is checked whenever the channel
+// publishes and by flush_incremental(true). Batches are split into
+// messages that fit one packet; only a single update larger than the MTU
+// goes out in a packet of its own, above the limit.
+//
+// Snapshots are split into MDFullRefresh fragments of one packet each, no
+// larger than packet_mtu (SNAPSHOT_PACKET_SIZE when it is 0), so a deep
+// book never needs IP fragmentation.
 class ReutersMulticastPublisher {
 public:
+    static constexpr size_t PACKET_HEADER_SIZE = 20; // Thomson Reuters Binary Packet Header
+    static constexpr size_t MAX_PACKET_SIZE = 65507; // Largest UDP payload
+    static constexpr size_t MAX_PENDING_UPDATES = 256; // Per channel; a full batch is sent at once
+    static constexpr size_t SNAPSHOT_PACKET_SIZE = 1472; // Ethernet MTU less IPv4 and UDP headers
+
     explicit ReutersMulticastPublisher(const ReutersMulticastConfig& config);
     ~ReutersMulticastPublisher();
 
@@ -62,10 +89,37 @@ public:
     // Market data distribution
     void publish_incremental(const market_core::QuoteEvent& quote);
     void publish_incremental(const market_core::TradeEvent& trade);
-    void publish_snapshot(const market_core::SnapshotEvent& snapshot);
-    void publish_security_definition(const market_core::Instrument& instrument);
+    void publish_incremental(const market_core::MarketEventRecord& record); // QUOTE_UPDATE or TRADE
+
+    // Records produced together, e.g. one generator block. Updates of the
+    // same instrument go out as one multi-entry message whatever the batch
+    // window; other record types are skipped.
+    void publish_incremental(const market_core::MarketEventRecord* records, size_t count);
+
+    // Send updates held back by batch_window_us and packets still filling:
+    // all of them, or with expired_only just those past their deadline
+    void flush_incremental(bool expired_only = false);
+
+    // Snapshots return the number of packets sent. The book and view forms
+    // allocate nothing once the level scratch has grown to the book depth.
+    size_t publish_snapshot(const market_core::SnapshotEvent& snapshot);
+    size_t publish_snapshot(const market_core::OrderBook& book, size_t max_levels); // rptSeq is the last applied sequence
+    size_t publish_snapshot(const SnapshotBookView& book);
+    void publish_security_definition(const market_core::Instrument& instrument); // Caches and sends now
     void publish_statistics(const market_core::StatisticsEvent& stats);
 
+    // Security definitions are encoded once into a cache. An entry is
+    // re-encoded only when the fields it carries change; true if the
+    // instrument was new or changed.
+    bool update_security_definition(const market_core::Instrument& instrument);
+    size_t security_definition_count() const { return definitions_.size(); }
+
+    // Rebroadcast the cache for late joiners as a cycle spread evenly over
+    // security_definition_interval_seconds: entry i of a cycle is due i/N of
+    // the way through it. Call often; sends what is due and returns how many.
+    size_t rebroadcast_security_definitions(
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now());
+
     // Heartbeat and sequence management
     void send_heartbeat();
     void send_end_of_conflation();
@@ -78,9 +132,17 @@ public:
 
     // Statistics
     struct PublisherStats {
-        uint64_t messages_sent_a = 0;
+        uint64_t messages_sent_a = 0; // Incremental SBE messages
         uint64_t messages_sent_b = 0;
+        uint64_t entries_sent = 0; // Updates carried by those messages
+        uint64_t packets_sent = 0; // Incremental feed packets, A/B counted once
+        uint64_t packet_messages = 0; // SBE messages carried by those packets
+        uint64_t packet_bytes = 0; // Their length including the packet header
+
+        double messages_per_packet() const { return packets_sent ? static_cast<double>(packet_messages) / packets_sent : 0.0; }
+        double bytes_per_packet() const { return packets_sent ? static_cast<double>(packet_bytes) / packets_sent : 0.0; }
         uint64_t snapshots_sent = 0;
+        uint64_t snapshot_packets = 0; // One fragment each
         uint64_t definitions_sent = 0;
         uint64_t heartbeats_sent = 0;
         uint64_t bytes_sent = 0;
@@ -106,12 +168,66 @@ private:
     // Sequence numbers per channel
     std::unordered_map<int, std::atomic<uint64_t>> sequence_numbers_;
 
-    // Instrument to channel mapping
-    std::unordered_map<uint32_t, int> instrument_channel_map_;
-
     // Channel enable/disable state
     std::unordered_map<int, std::atomic<bool>> channel_enabled_;
 
+    // Send path of one incremental channel, resolved once by initialize().
+    // Route 0 is the global A/B feeds, the rest follow channel_feeds_a.
+    struct FeedRoute {
+        int channel_id = 0;
+        protocol_common::UDPTransport* feed_a = nullptr;
+        protocol_common::UDPTransport* feed_b = nullptr;
+        std::atomic<uint64_t>* sequence = nullptr; // Entry in sequence_numbers_
+        std::atomic<bool>* enabled = nullptr; // Entry in channel_enabled_; null = always on
+        std::vector<uint8_t> packet; // Header and SBE body are encoded here
+        size_t packet_length = 0; // Bytes used, header included; 0 = no packet open
+        uint32_t packet_count = 0; // Messages in the open packet
+        std::chrono::steady_clock::time_point packet_opened;
+
+        // Updates waiting for the batch window, and flush scratch
+        std::vector<market_core::MarketEventRecord> pending;
+        std::chrono::steady_clock::time_point pending_since;
+        std::vector<const market_core::MarketEventRecord*> batch;
+        std::vector<uint8_t> batched;
+    };
+    std::vector<FeedRoute> routes_;
+
+    // Instrument to index in routes_
+    std::unordered_map<uint32_t, uint32_t> instrument_routes_;
+
+    // Snapshots and security definitions, which have feeds of their own.
+    // Each feed numbers its packets itself, so neither leaves gaps in the
+    // incremental MsgSeqNum that snapshots report as processed.
+    std::vector<uint8_t> control_packet_;
+    uint64_t snapshot_sequence_ = 0;
+    uint64_t definition_sequence_ = 0;
+
+    // Snapshot levels copied out of a book, reused between snapshots
+    std::vector<market_core::PriceLevel> snapshot_bids_;
+    std::vector<market_core::PriceLevel> snapshot_asks_;
+    size_t snapshot_limit_ = SNAPSHOT_PACKET_SIZE;
+    size_t snapshot_fragment_entries_ = 0;
+
+    // Encoded security definitions, back to back in definition_bytes_
+    struct CachedDefinition {
+        uint32_t instrument_id;
+        uint32_t length;
+        size_t offset;
+        uint64_t fingerprint;
+    };
+    std::vector<CachedDefinition> definitions_;
+    std::unordered_map<uint32_t, uint32_t> definition_index_;
+    std::vector<uint8_t> definition_bytes_;
+    size_t definition_cursor_ = 0; // Next entry of the rebroadcast cycle
+    bool definition_cycle_started_ = false;
+    std::chrono::steady_clock::time_point definition_cycle_start_;
+
+    // Packing limits resolved from the config
+    size_t packet_limit_ = MAX_PACKET_SIZE;
+    size_t quote_batch_entries_ = 1; // Per message, so a batch fits packet_limit_
+    size_t trade_batch_entries_ = 1;
+    std::chrono::microseconds packet_max_latency_ { 0 };
+
     // Timing
     std::chrono::steady_clock::time_point last_heartbeat_;
     std::chrono::steady_clock::time_point last_snapshot_;
@@ -119,10 +235,17 @@ private:
     // Internal methods
     bool create_multicast_socket(const MulticastChannelConfig& config,
         std::unique_ptr<protocol_common::UDPTransport>& transport);
-    void send_to_both_feeds(const std::vector<uint8_t>& message, int channel_id);
-    void send_to_channel_feeds(const std::vector<uint8_t>& message, int channel_id);
-    std::vector<uint8_t> add_sequence_header(const std::vector<uint8_t>& message,
-        uint64_t sequence, int channel_id);
+    FeedRoute* route_for(uint32_t instrument_id); // Falls back to route 0; nullptr before initialize()
+    uint64_t incremental_sequence(uint32_t instrument_id); // Flushes the instrument's channel, then its last sequence
+    void send_packet(FeedRoute& route, size_t length); // Stamps the header over packet[0, length)
+    template <typename Encode>
+    bool append_message(FeedRoute& route, Encode encode); // encode(buffer, offset, capacity) -> length
+    void flush_packet(FeedRoute& route);
+    void send_definition(const CachedDefinition& definition);
+    void send_incremental(FeedRoute& route, const market_core::MarketEventRecord* const* records, size_t count);
+    void queue_incremental(FeedRoute& route, const market_core::MarketEventRecord& record);
+    void flush_route(FeedRoute& route);
+    static void write_packet_header(uint8_t* packet, uint64_t sequence, size_t length);
 };
 
 // Multicast-specific message header for sequencing
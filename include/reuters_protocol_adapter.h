@@ -20,15 +20,21 @@ public:
 
     // IMarketEventListener implementation
     void on_market_event(const std::shared_ptr<market_core::MarketEvent>& event) override;
+    void on_market_event(const market_core::MarketEventRecord& record) override;
+    void on_market_events(const market_core::MarketEventRecord* records, size_t count) override;
 
     // UTP multicast server operations
     bool initialize_with_multicast(); // Initialize UTP multicast publisher
     void run_once(); // Process one iteration of server loop
     void shutdown();
 
-    // Send security definitions via multicast
+    // Send new or changed security definitions via multicast
     void send_security_definitions(const std::vector<market_core::Instrument>& instruments);
 
+    // Snapshot of up to max_levels per side straight from the book, in as
+    // many snapshot packets as its depth needs
+    void publish_book_snapshot(const market_core::OrderBook& book, size_t max_levels);
+
     // Statistics - put non-atomic members first to avoid alignment issues
     struct Statistics {
         std::chrono::steady_clock::time_point start_time;  // Move to front
@@ -82,13 +88,19 @@ public:
         return 0;
     }
 
+    // Publisher counters; kept after shutdown for the final report
+    ReutersMulticastPublisher::PublisherStats get_publisher_statistics() const
+    {
+        return multicast_publisher_ ? multicast_publisher_->get_statistics() : final_publisher_stats_;
+    }
+
 private:
     uint16_t port_;
     bool running_;
     Statistics stats_;
     ReutersMulticastConfig multicast_config_;
     std::unique_ptr<ReutersMulticastPublisher> multicast_publisher_;
-    std::unique_ptr<std::vector<market_core::Instrument>> instruments_;
+    ReutersMulticastPublisher::PublisherStats final_publisher_stats_;
 };
 
 } // namespace reuters_protocol
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "instrument.h"
+#include "order_book.h"
+#include "synthetic_universe.h"
+#include "reuters_multicast_publisher.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace reuters_protocol {
+
+// Everything the multicast server reads from config/reuters_config.json
+struct ServerConfig {
+    uint16_t tcp_port = 11501;
+    ReutersMulticastConfig multicast;
+
+    // Instruments listed in the file, followed by the synthetic universe
+    std::vector<std::shared_ptr<market_core::Instrument>> instruments;
+
+    // Synthetic instruments generated on top of the listed ones
+    market_core::UniverseSpec universe;
+    bool assign_universe_channels = true; // Spread synthetic instruments round-robin over the channels
+
+    // Order book storage; AUTO uses tick ladders up to LARGE_UNIVERSE
+    // instruments and price maps beyond, where ladder memory dominates
+    enum class BookEngine {
+        AUTO,
+        TICK_LADDER,
+        PRICE_MAP
+    };
+    static constexpr size_t LARGE_UNIVERSE = 10000;
+
+    BookEngine book_engine = BookEngine::AUTO;
+    size_t ladder_window_ticks = 0; // 0 = OrderBook default
+    size_t trade_history_capacity = 0; // 0 = OrderBook default, 16 for large universes
+
+    // Book settings for the configured instrument count
+    market_core::OrderBook::Config book_config() const;
+};
+
+// Built-in setup: seven FX pairs on two channels with the 239.100.x feeds
+ServerConfig default_server_config();
+
+// Overlay the file on config; each section present in the file replaces
+// the corresponding part of config wholesale. Returns false, leaving config
+// untouched, if the file cannot be opened; throws std::runtime_error if it
+// is not valid JSON or names an unknown instrument type.
+bool load_server_config(const std::string& path, ServerConfig& config);
+
+// Append config.universe.count synthetic instruments and resolve channel
+// membership to instrument IDs. Call once, after load_server_config and
+// any command-line overrides. Throws std::runtime_error if a channel names
+// a symbol that is not configured.
+void finalize_server_config(ServerConfig& config);
+
+} // namespace reuters_protocol
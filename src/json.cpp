@@ -0,0 +1,268 @@
+#include "../include/common/json.h"
+#include <cstdlib>
+#include <stdexcept>
+
+namespace protocol_common {
+
+// Recursive-descent parser over the whole document
+class JsonParser {
+public:
+    explicit JsonParser(const std::string& text)
+        : text_(text)
+    {
+    }
+
+    JsonValue parse_document()
+    {
+        JsonValue value = parse_value(0);
+        skip_whitespace();
+        if (pos_ != text_.size()) {
+            fail("trailing characters");
+        }
+        return value;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 128;
+
+    const std::string& text_;
+    size_t pos_ = 0;
+
+    [[noreturn]] void fail(const std::string& what) const
+    {
+        throw std::runtime_error("JSON parse error at offset " + std::to_string(pos_) + ": " + what);
+    }
+
+    void skip_whitespace()
+    {
+        while (pos_ < text_.size()
+            && (text_[pos_] == ' ' || text_[pos_] == '\t' || text_[pos_] == '\n' || text_[pos_] == '\r')) {
+            ++pos_;
+        }
+    }
+
+    char peek()
+    {
+        skip_whitespace();
+        if (pos_ >= text_.size()) {
+            fail("unexpected end of input");
+        }
+        return text_[pos_];
+    }
+
+    void expect(char c)
+    {
+        if (peek() != c) {
+            fail(std::string("expected '") + c + "'");
+        }
+        ++pos_;
+    }
+
+    bool consume_literal(const char* literal)
+    {
+        size_t length = std::char_traits<char>::length(literal);
+        if (text_.compare(pos_, length, literal) == 0) {
+            pos_ += length;
+            return true;
+        }
+        return false;
+    }
+
+    JsonValue parse_value(int depth)
+    {
+        if (depth > MAX_DEPTH) {
+            fail("nesting too deep");
+        }
+
+        JsonValue value;
+        char c = peek();
+        if (c == '{') {
+            ++pos_;
+            value.type_ = JsonValue::Type::OBJECT;
+            if (peek() == '}') {
+                ++pos_;
+                return value;
+            }
+            for (;;) {
+                if (peek() != '"') {
+                    fail("expected member name");
+                }
+                std::string key = parse_string();
+                expect(':');
+                value.members_.emplace_back(std::move(key), parse_value(depth + 1));
+                if (peek() == ',') {
+                    ++pos_;
+                    continue;
+                }
+                expect('}');
+                return value;
+            }
+        }
+        if (c == '[') {
+            ++pos_;
+            value.type_ = JsonValue::Type::ARRAY;
+            if (peek() == ']') {
+                ++pos_;
+                return value;
+            }
+            for (;;) {
+                value.items_.push_back(parse_value(depth + 1));
+                if (peek() == ',') {
+                    ++pos_;
+                    continue;
+                }
+                expect(']');
+                return value;
+            }
+        }
+        if (c == '"') {
+            value.type_ = JsonValue::Type::STRING;
+            value.string_ = parse_string();
+            return value;
+        }
+        if (consume_literal("true")) {
+            value.type_ = JsonValue::Type::BOOLEAN;
+            value.bool_ = true;
+            return value;
+        }
+        if (consume_literal("false")) {
+            value.type_ = JsonValue::Type::BOOLEAN;
+            return value;
+        }
+        if (consume_literal("null")) {
+            return value;
+        }
+        if (c == '-' || (c >= '0' && c <= '9')) {
+            const char* begin = text_.c_str() + pos_;
+            char* end = nullptr;
+            value.type_ = JsonValue::Type::NUMBER;
+            value.number_ = std::strtod(begin, &end);
+            if (end == begin) {
+                fail("bad number");
+            }
+            pos_ += static_cast<size_t>(end - begin);
+            return value;
+        }
+        fail(std::string("unexpected character '") + c + "'");
+    }
+
+    std::string parse_string()
+    {
+        ++pos_; // Opening quote
+        std::string result;
+        while (pos_ < text_.size()) {
+            char c = text_[pos_++];
+            if (c == '"') {
+                return result;
+            }
+            if (c != '\\') {
+                result += c;
+                continue;
+            }
+            if (pos_ >= text_.size()) {
+                break;
+            }
+            char escape = text_[pos_++];
+            switch (escape) {
+            case '"':
+            case '\\':
+            case '/':
+                result += escape;
+                break;
+            case 'b':
+                result += '\b';
+                break;
+            case 'f':
+                result += '\f';
+                break;
+            case 'n':
+                result += '\n';
+                break;
+            case 'r':
+                result += '\r';
+                break;
+            case 't':
+                result += '\t';
+                break;
+            case 'u':
+                append_utf8(parse_hex4(), result);
+                break;
+            default:
+                fail("bad escape");
+            }
+        }
+        fail("unterminated string");
+    }
+
+    unsigned parse_hex4()
+    {
+        if (pos_ + 4 > text_.size()) {
+            fail("bad \\u escape");
+        }
+        unsigned code = 0;
+        for (int i = 0; i < 4; ++i) {
+            char c = text_[pos_++];
+            code <<= 4;
+            if (c >= '0' && c <= '9') {
+                code |= c - '0';
+            } else if (c >= 'a' && c <= 'f') {
+                code |= c - 'a' + 10;
+            } else if (c >= 'A' && c <= 'F') {
+                code |= c - 'A' + 10;
+            } else {
+                fail("bad \\u escape");
+            }
+        }
+        return code;
+    }
+
+    // Basic multilingual plane only; config files are ASCII in practice
+    static void append_utf8(unsigned code, std::string& out)
+    {
+        if (code < 0x80) {
+            out += static_cast<char>(code);
+        } else if (code < 0x800) {
+            out += static_cast<char>(0xC0 | (code >> 6));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        } else {
+            out += static_cast<char>(0xE0 | (code >> 12));
+            out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+            out += static_cast<char>(0x80 | (code & 0x3F));
+        }
+    }
+};
+
+JsonValue JsonValue::parse(const std::string& text)
+{
+    return JsonParser(text).parse_document();
+}
+
+const JsonValue* JsonValue::find(const std::string& key) const
+{
+    for (const auto& member : members_) {
+        if (member.first == key) {
+            return &member.second;
+        }
+    }
+    return nullptr;
+}
+
+double JsonValue::number(const std::string& key, double fallback) const
+{
+    const JsonValue* value = find(key);
+    return value ? value->as_number(fallback) : fallback;
+}
+
+bool JsonValue::boolean(const std::string& key, bool fallback) const
+{
+    const JsonValue* value = find(key);
+    return value ? value->as_bool(fallback) : fallback;
+}
+
+std::string JsonValue::string(const std::string& key, const std::string& fallback) const
+{
+    const JsonValue* value = find(key);
+    return value ? value->as_string(fallback) : fallback;
+}
+
+} // namespace protocol_common
@@ -8,94 +8,164 @@
 #include <algorithm>
 #include <arpa/inet.h>
 #include <chrono>
+#include <cmath>
 #include <cstring>
 
 namespace reuters_protocol {
 
+// SecurityDefinition fields not taken from the instrument. The fingerprint
+// hashes them too, so changing one here re-encodes every cached entry.
+static constexpr auto DEFINITION_UPDATE_ACTION = utp_sbe::SecurityUpdateAction::Value::ADD;
+static constexpr char DEFINITION_CURRENCY_1[] = "USD";
+static constexpr char DEFINITION_CURRENCY_2[] = "EUR";
+
+// Write the SBE message header for Message at buffer + offset
+template <typename Message>
+static void wrap_header(utp_sbe::MessageHeader& header, uint8_t* buffer, size_t offset, size_t capacity)
+{
+    header.wrap(reinterpret_cast<char*>(buffer), offset, 0, capacity)
+        .blockLength(Message::SBE_BLOCK_LENGTH)
+        .templateId(Message::SBE_TEMPLATE_ID)
+        .schemaId(Message::SBE_SCHEMA_ID)
+        .version(Message::SBE_SCHEMA_VERSION);
+}
+
+// Whether a message of length bytes fits at offset. If it does, the bytes
+// are cleared: buffers are reused, and fields the encoder leaves unset must
+// not carry whatever the previous message put there.
+static bool fits(uint8_t* buffer, size_t offset, size_t length, size_t capacity)
+{
+    if (offset > capacity || length > capacity - offset) {
+        return false;
+    }
+    memset(buffer + offset, 0, length);
+    return true;
+}
+
 std::vector<uint8_t> ReutersEncoder::encode_heartbeat()
 {
     std::vector<uint8_t> buffer(1024);
+    buffer.resize(encode_heartbeat(buffer.data(), 0, buffer.size()));
+    return buffer;
+}
+
+size_t ReutersEncoder::encode_heartbeat(uint8_t* buffer, size_t offset, size_t capacity)
+{
+    if (!fits(buffer, offset, utp_sbe::MessageHeader::encodedLength() + utp_sbe::AdminHeartbeat::computeLength(), capacity)) {
+        return 0;
+    }
 
     // Initialize SBE message header first
     utp_sbe::MessageHeader header;
-    header.wrap(reinterpret_cast<char*>(buffer.data()), 0, 0, buffer.size())
-        .blockLength(utp_sbe::AdminHeartbeat::SBE_BLOCK_LENGTH)
-        .templateId(utp_sbe::AdminHeartbeat::SBE_TEMPLATE_ID)
-        .schemaId(utp_sbe::AdminHeartbeat::SBE_SCHEMA_ID)
-        .version(utp_sbe::AdminHeartbeat::SBE_SCHEMA_VERSION);
+    wrap_header<utp_sbe::AdminHeartbeat>(header, buffer, offset, capacity);
 
     // UTP Admin Heartbeat is very simple - just header
     utp_sbe::AdminHeartbeat heartbeat;
-    heartbeat.wrapForEncode(reinterpret_cast<char*>(buffer.data()), header.encodedLength(), buffer.size());
+    heartbeat.wrapForEncode(reinterpret_cast<char*>(buffer), offset + header.encodedLength(), capacity);
 
-    size_t encoded_length = header.encodedLength() + heartbeat.encodedLength();
-    buffer.resize(encoded_length);
-    return buffer;
+    return header.encodedLength() + heartbeat.encodedLength();
 }
 
 std::vector<uint8_t> ReutersEncoder::encode_security_definition(
     const market_core::Instrument& instrument)
 {
     std::vector<uint8_t> buffer(1024);
+    buffer.resize(encode_security_definition(instrument, buffer.data(), 0, buffer.size()));
+    return buffer;
+}
+
+size_t ReutersEncoder::encode_security_definition(
+    const market_core::Instrument& instrument, uint8_t* buffer, size_t offset, size_t capacity)
+{
+    if (!fits(buffer, offset, utp_sbe::MessageHeader::encodedLength() + utp_sbe::SecurityDefinition::computeLength(), capacity)) {
+        return 0;
+    }
 
     // Initialize SBE message header first
     utp_sbe::MessageHeader header;
-    header.wrap(reinterpret_cast<char*>(buffer.data()), 0, 0, buffer.size())
-        .blockLength(utp_sbe::SecurityDefinition::SBE_BLOCK_LENGTH)
-        .templateId(utp_sbe::SecurityDefinition::SBE_TEMPLATE_ID)
-        .schemaId(utp_sbe::SecurityDefinition::SBE_SCHEMA_ID)
-        .version(utp_sbe::SecurityDefinition::SBE_SCHEMA_VERSION);
+    wrap_header<utp_sbe::SecurityDefinition>(header, buffer, offset, capacity);
 
     // Initialize SecurityDefinition message after header
     utp_sbe::SecurityDefinition secDef;
-    secDef.wrapForEncode(reinterpret_cast<char*>(buffer.data()), header.encodedLength(), buffer.size());
+    secDef.wrapForEncode(reinterpret_cast<char*>(buffer), offset + header.encodedLength(), capacity);
 
     // Set basic instrument fields using the correct UTP SBE methods
     // SecurityUpdateAction is REQUIRED as the first field (offset 0)
-    secDef.securityUpdateAction(utp_sbe::SecurityUpdateAction::Value::ADD);  // 'A' for new instruments
-    secDef.lastUpdateTime(std::chrono::duration_cast<std::chrono::nanoseconds>(
-        std::chrono::system_clock::now().time_since_epoch())
-                              .count());
+    secDef.securityUpdateAction(DEFINITION_UPDATE_ACTION);  // 'A' for new instruments
+    secDef.lastUpdateTime(get_current_timestamp_ns());
     // applID is set automatically by the schema
     secDef.securityID(instrument.instrument_id);
     secDef.putSymbol(instrument.primary_symbol);
-    secDef.putCurrency1("USD");
-    secDef.putCurrency2("EUR");
+    secDef.putCurrency1(DEFINITION_CURRENCY_1);
+    secDef.putCurrency2(DEFINITION_CURRENCY_2);
 
-    size_t encoded_length = header.encodedLength() + secDef.encodedLength();
-    buffer.resize(encoded_length);
-    return buffer;
+    return header.encodedLength() + secDef.encodedLength();
+}
+
+uint64_t ReutersEncoder::security_definition_fingerprint(const market_core::Instrument& instrument)
+{
+    // FNV-1a over every field encode_security_definition writes except
+    // lastUpdateTime, which then stamps when the definition last changed.
+    // Strings are mixed with their length so adjacent fields cannot alias.
+    uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t length) {
+        const auto* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < length; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    auto mix_string = [&mix](const char* text, size_t length) {
+        mix(&length, sizeof(length));
+        mix(text, length);
+    };
+    auto action = static_cast<char>(DEFINITION_UPDATE_ACTION);
+    mix(&action, sizeof(action));
+    mix(&instrument.instrument_id, sizeof(instrument.instrument_id));
+    mix_string(instrument.primary_symbol.data(), instrument.primary_symbol.size());
+    mix_string(DEFINITION_CURRENCY_1, sizeof(DEFINITION_CURRENCY_1) - 1);
+    mix_string(DEFINITION_CURRENCY_2, sizeof(DEFINITION_CURRENCY_2) - 1);
+    return hash;
 }
 
 std::vector<uint8_t> ReutersEncoder::encode_market_data_snapshot(
     const market_core::SnapshotEvent& snapshot)
 {
-    std::vector<uint8_t> buffer(4096);
+    // Exact size, so deep books are never cut off
+    size_t levels = snapshot.bid_levels.size() + snapshot.ask_levels.size();
+    std::vector<uint8_t> buffer(utp_sbe::MessageHeader::encodedLength() + utp_sbe::MDFullRefresh::computeLength(std::min<size_t>(levels, UINT16_MAX - 1)));
+    buffer.resize(encode_market_data_snapshot(snapshot, buffer.data(), 0, buffer.size()));
+    return buffer;
+}
+
+size_t ReutersEncoder::encode_market_data_snapshot(
+    const market_core::SnapshotEvent& snapshot, uint8_t* buffer, size_t offset, size_t capacity)
+{
+    size_t levels = snapshot.bid_levels.size() + snapshot.ask_levels.size();
+    if (levels >= UINT16_MAX
+        || !fits(buffer, offset, utp_sbe::MessageHeader::encodedLength() + utp_sbe::MDFullRefresh::computeLength(levels), capacity)) {
+        return 0;
+    }
 
     // Initialize SBE message header first
     utp_sbe::MessageHeader header;
-    header.wrap(reinterpret_cast<char*>(buffer.data()), 0, 0, buffer.size())
-        .blockLength(utp_sbe::MDFullRefresh::SBE_BLOCK_LENGTH)
-        .templateId(utp_sbe::MDFullRefresh::SBE_TEMPLATE_ID)
-        .schemaId(utp_sbe::MDFullRefresh::SBE_SCHEMA_ID)
-        .version(utp_sbe::MDFullRefresh::SBE_SCHEMA_VERSION);
+    wrap_header<utp_sbe::MDFullRefresh>(header, buffer, offset, capacity);
 
     // Initialize MDFullRefresh message after header
     utp_sbe::MDFullRefresh mdSnapshot;
-    mdSnapshot.wrapForEncode(reinterpret_cast<char*>(buffer.data()), header.encodedLength(), buffer.size());
+    mdSnapshot.wrapForEncode(reinterpret_cast<char*>(buffer), offset + header.encodedLength(), capacity);
 
     mdSnapshot.securityID(snapshot.instrument_id)
         .transactTime(snapshot.timestamp_ns)
         .rptSeq(snapshot.sequence_number);
 
     // Add bid/ask levels using repeating group
-    auto& entries = mdSnapshot.noMDEntriesCount(static_cast<uint16_t>(snapshot.bid_levels.size() + snapshot.ask_levels.size()));
+    auto& entries = mdSnapshot.noMDEntriesCount(static_cast<uint16_t>(levels));
 
     // Add bid levels
     for (const auto& level : snapshot.bid_levels) {
         auto& entry = entries.next();
         entry.mDEntryType(utp_sbe::MDEntryType::BID);
-        entry.mDEntryPx().mantissa(static_cast<int64_t>(level.price * 1e9)); // Convert to fixed point
+        entry.mDEntryPx().mantissa(to_sbe_decimal(level.price));
         entry.mDEntrySize(level.quantity);
         // numberOfOrders not available in UTP MDFullRefresh
     }
@@ -104,92 +174,205 @@ std::vector<uint8_t> ReutersEncoder::encode_market_data_snapshot(
     for (const auto& level : snapshot.ask_levels) {
         auto& entry = entries.next();
         entry.mDEntryType(utp_sbe::MDEntryType::OFFER);
-        entry.mDEntryPx().mantissa(static_cast<int64_t>(level.price * 1e9)); // Convert to fixed point
+        entry.mDEntryPx().mantissa(to_sbe_decimal(level.price));
         entry.mDEntrySize(level.quantity);
         // numberOfOrders not available in UTP MDFullRefresh
     }
 
-    size_t encoded_length = header.encodedLength() + mdSnapshot.encodedLength();
-    buffer.resize(encoded_length);
-    return buffer;
+    return header.encodedLength() + mdSnapshot.encodedLength();
 }
 
-std::vector<uint8_t> ReutersEncoder::encode_market_data_incremental(
-    const market_core::QuoteEvent& quote)
+size_t ReutersEncoder::encode_market_data_snapshot(const SnapshotBookView& book, size_t first, size_t count,
+    uint8_t* buffer, size_t offset, size_t capacity)
 {
-    std::vector<uint8_t> buffer(1024);
+    if (first > book.entry_count() || count > book.entry_count() - first || count >= UINT16_MAX
+        || !fits(buffer, offset, utp_sbe::MessageHeader::encodedLength() + utp_sbe::MDFullRefresh::computeLength(count), capacity)) {
+        return 0;
+    }
 
-    // Initialize SBE message header first
     utp_sbe::MessageHeader header;
-    header.wrap(reinterpret_cast<char*>(buffer.data()), 0, 0, buffer.size())
-        .blockLength(utp_sbe::MDIncrementalRefresh::SBE_BLOCK_LENGTH)
-        .templateId(utp_sbe::MDIncrementalRefresh::SBE_TEMPLATE_ID)
-        .schemaId(utp_sbe::MDIncrementalRefresh::SBE_SCHEMA_ID)
-        .version(utp_sbe::MDIncrementalRefresh::SBE_SCHEMA_VERSION);
-
-    // Initialize MDIncrementalRefresh message after header
-    utp_sbe::MDIncrementalRefresh mdIncremental;
-    mdIncremental.wrapForEncode(reinterpret_cast<char*>(buffer.data()), header.encodedLength(), buffer.size());
-
-    // Set message-level fields
-    mdIncremental.securityID(quote.instrument_id)
-        .rptSeq(quote.sequence_number)
-        .transactTime(quote.timestamp_ns);
-
-    // Add entry in the repeating group
-    auto& entries = mdIncremental.noMDEntriesCount(1);
-    auto& entry = entries.next();
-
-    entry.mDUpdateAction(static_cast<utp_sbe::MDUpdateAction::Value>(quote.action))
-        .mDEntryType(quote.side == market_core::Side::BID ? utp_sbe::MDEntryType::BID : utp_sbe::MDEntryType::OFFER);
-    entry.mDEntryPx().mantissa(static_cast<int64_t>(quote.price * 1e9)); // Convert to fixed point
-    entry.mDEntrySize(quote.quantity);
-
-    size_t encoded_length = header.encodedLength() + mdIncremental.encodedLength();
-    buffer.resize(encoded_length);
-    return buffer;
+    wrap_header<utp_sbe::MDFullRefresh>(header, buffer, offset, capacity);
+
+    utp_sbe::MDFullRefresh mdSnapshot;
+    mdSnapshot.wrapForEncode(reinterpret_cast<char*>(buffer), offset + header.encodedLength(), capacity);
+
+    mdSnapshot.lastMsgSeqNumProcessed(static_cast<int64_t>(book.last_msg_seq_num_processed))
+        .securityID(book.instrument_id)
+        .rptSeq(static_cast<int64_t>(book.rpt_seq))
+        .transactTime(book.transact_time)
+        .marketDepth(static_cast<uint8_t>(std::min<size_t>(std::max(book.bid_count, book.ask_count), UINT8_MAX)));
+
+    auto& entries = mdSnapshot.noMDEntriesCount(static_cast<uint16_t>(count));
+    for (size_t i = first; i < first + count; ++i) {
+        bool bid = i < book.bid_count;
+        const market_core::PriceLevel& level = bid ? book.bids[i] : book.asks[i - book.bid_count];
+        auto& entry = entries.next();
+        entry.mDEntryType(bid ? utp_sbe::MDEntryType::BID : utp_sbe::MDEntryType::OFFER);
+        entry.mDEntryPx().mantissa(to_sbe_decimal(level.price));
+        entry.mDEntrySize(level.quantity);
+    }
+
+    return header.encodedLength() + mdSnapshot.encodedLength();
+}
+
+// Most group entries a Message of at most max_length bytes, SBE header
+// included, can carry
+template <typename Message>
+static size_t entries_within(size_t max_length)
+{
+    size_t fixed = utp_sbe::MessageHeader::encodedLength() + Message::computeLength(0);
+    if (max_length <= fixed) {
+        return 0;
+    }
+    size_t entry = Message::computeLength(1) - Message::computeLength(0);
+    return std::min<size_t>((max_length - fixed) / entry, UINT16_MAX - 1);
+}
+
+size_t ReutersEncoder::snapshot_fragment_entries(size_t max_length)
+{
+    return entries_within<utp_sbe::MDFullRefresh>(max_length);
+}
+
+size_t ReutersEncoder::incremental_message_entries(market_core::MarketEvent::EventType type, size_t max_length)
+{
+    if (type == market_core::MarketEvent::QUOTE_UPDATE) {
+        return entries_within<utp_sbe::MDIncrementalRefresh>(max_length);
+    }
+    if (type == market_core::MarketEvent::TRADE) {
+        return entries_within<utp_sbe::MDIncrementalRefreshTrades>(max_length);
+    }
+    return 0;
+}
+
+std::vector<uint8_t> ReutersEncoder::encode_market_data_incremental(
+    const market_core::QuoteEvent& quote)
+{
+    market_core::MarketEventRecord record;
+    market_core::to_record(quote, record);
+    return encode_market_data_incremental(record);
 }
 
 std::vector<uint8_t> ReutersEncoder::encode_market_data_incremental(
     const market_core::TradeEvent& trade)
+{
+    market_core::MarketEventRecord record;
+    market_core::to_record(trade, record);
+    return encode_market_data_incremental(record);
+}
+
+std::vector<uint8_t> ReutersEncoder::encode_market_data_incremental(
+    const market_core::MarketEventRecord& record)
 {
     std::vector<uint8_t> buffer(1024);
+    buffer.resize(encode_market_data_incremental(record, buffer.data(), 0, buffer.size()));
+    return buffer;
+}
+
+size_t ReutersEncoder::encode_market_data_incremental(
+    const market_core::MarketEventRecord& record, uint8_t* buffer, size_t offset, size_t capacity)
+{
+    const market_core::MarketEventRecord* records = &record;
+    return encode_market_data_incremental(&records, 1, buffer, offset, capacity);
+}
+
+size_t ReutersEncoder::encode_market_data_incremental(const market_core::MarketEventRecord* const* records,
+    size_t count, uint8_t* buffer, size_t offset, size_t capacity)
+{
+    if (count == 0 || count >= UINT16_MAX) {
+        return 0;
+    }
+    const market_core::MarketEventRecord& first = *records[0];
+    const market_core::MarketEventRecord& last = *records[count - 1];
+    for (size_t i = 1; i < count; ++i) {
+        if (records[i]->type != first.type || records[i]->instrument_id != first.instrument_id) {
+            return 0; // One message carries one SecurityID and one message type
+        }
+    }
 
-    // Initialize SBE message header first
     utp_sbe::MessageHeader header;
-    header.wrap(reinterpret_cast<char*>(buffer.data()), 0, 0, buffer.size())
-        .blockLength(utp_sbe::MDIncrementalRefreshTrades::SBE_BLOCK_LENGTH)
-        .templateId(utp_sbe::MDIncrementalRefreshTrades::SBE_TEMPLATE_ID)
-        .schemaId(utp_sbe::MDIncrementalRefreshTrades::SBE_SCHEMA_ID)
-        .version(utp_sbe::MDIncrementalRefreshTrades::SBE_SCHEMA_VERSION);
-
-    // Initialize MDIncrementalRefreshTrades message after header
-    utp_sbe::MDIncrementalRefreshTrades mdTrade;
-    mdTrade.wrapForEncode(reinterpret_cast<char*>(buffer.data()), header.encodedLength(), buffer.size());
-
-    // Set message-level fields
-    mdTrade.securityID(trade.instrument_id);
-
-    // Add entry in the repeating group
-    auto& entries = mdTrade.noMDEntriesCount(1);
-    auto& entry = entries.next();
-
-    entry.transactTime(trade.timestamp_ns);
-    entry.mDEntryPx().mantissa(static_cast<int64_t>(trade.price * 1e9)); // Convert to fixed point
-    entry.mDEntrySize(trade.quantity);
-
-    // Set aggressor side if available
-    if (trade.aggressor_side.has_value()) {
-        entry.aggressorSide(trade.aggressor_side.value() == market_core::Side::BID ? utp_sbe::AggressorSide::BUYSIDE : utp_sbe::AggressorSide::SELLSIDE);
-    } else {
-        entry.aggressorSide(utp_sbe::AggressorSide::NONE);
+
+    if (first.type == market_core::MarketEvent::QUOTE_UPDATE) {
+        if (!fits(buffer, offset, utp_sbe::MessageHeader::encodedLength() + utp_sbe::MDIncrementalRefresh::computeLength(count), capacity)) {
+            return 0;
+        }
+
+        // Initialize SBE message header first
+        wrap_header<utp_sbe::MDIncrementalRefresh>(header, buffer, offset, capacity);
+
+        // Initialize MDIncrementalRefresh message after header
+        utp_sbe::MDIncrementalRefresh mdIncremental;
+        mdIncremental.wrapForEncode(reinterpret_cast<char*>(buffer), offset + header.encodedLength(), capacity);
+
+        // Set message-level fields: rptSeq is the first entry's, entry i is rptSeq + i
+        mdIncremental.securityID(first.instrument_id)
+            .rptSeq(first.sequence_number)
+            .transactTime(last.timestamp_ns);
+
+        // One entry per update in the repeating group
+        auto& entries = mdIncremental.noMDEntriesCount(static_cast<uint16_t>(count));
+        for (size_t i = 0; i < count; ++i) {
+            const market_core::QuotePayload& quote = records[i]->quote;
+            auto& entry = entries.next();
+            entry.mDUpdateAction(static_cast<utp_sbe::MDUpdateAction::Value>(quote.action))
+                .mDEntryType(quote.side == market_core::Side::BID ? utp_sbe::MDEntryType::BID : utp_sbe::MDEntryType::OFFER);
+            entry.mDEntryPx().mantissa(to_sbe_decimal(quote.price));
+            entry.mDEntrySize(quote.quantity);
+        }
+
+        return header.encodedLength() + mdIncremental.encodedLength();
     }
 
-    size_t encoded_length = header.encodedLength() + mdTrade.encodedLength();
-    buffer.resize(encoded_length);
-    return buffer;
+    if (first.type == market_core::MarketEvent::TRADE) {
+        if (!fits(buffer, offset, utp_sbe::MessageHeader::encodedLength() + utp_sbe::MDIncrementalRefreshTrades::computeLength(count), capacity)) {
+            return 0;
+        }
+
+        // Initialize SBE message header first
+        wrap_header<utp_sbe::MDIncrementalRefreshTrades>(header, buffer, offset, capacity);
+
+        // Initialize MDIncrementalRefreshTrades message after header
+        utp_sbe::MDIncrementalRefreshTrades mdTrade;
+        mdTrade.wrapForEncode(reinterpret_cast<char*>(buffer), offset + header.encodedLength(), capacity);
+
+        // Set message-level fields
+        mdTrade.securityID(first.instrument_id);
+
+        // One entry per trade in the repeating group
+        auto& entries = mdTrade.noMDEntriesCount(static_cast<uint16_t>(count));
+        for (size_t i = 0; i < count; ++i) {
+            const market_core::TradePayload& trade = records[i]->trade;
+            auto& entry = entries.next();
+            entry.transactTime(records[i]->timestamp_ns);
+            entry.mDEntryPx().mantissa(to_sbe_decimal(trade.price));
+            entry.mDEntrySize(trade.quantity);
+
+            // Set aggressor side if available
+            if (trade.aggressor_side != market_core::Side::NONE) {
+                entry.aggressorSide(trade.aggressor_side == market_core::Side::BID ? utp_sbe::AggressorSide::BUYSIDE : utp_sbe::AggressorSide::SELLSIDE);
+            } else {
+                entry.aggressorSide(utp_sbe::AggressorSide::NONE);
+            }
+        }
+
+        return header.encodedLength() + mdTrade.encodedLength();
+    }
+
+    return 0;
+}
+
+uint64_t ReutersEncoder::get_current_timestamp_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch())
+        .count();
+}
+
+int64_t ReutersEncoder::to_sbe_decimal(double price)
+{
+    // Round to the nearest 1e-9: truncating turns 1.0851 into 1.085099999
+    return std::llround(price * 1e9);
 }
 
 // UTP is pure market data multicast - no session management functions needed
 
-} // namespace reuters_protocol
\ No newline at end of file
+} // namespace reuters_protocol
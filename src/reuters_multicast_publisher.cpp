@@ -1,4 +1,5 @@
 #include "../include/reuters_multicast_publisher.h"
+#include <algorithm>
 #include <arpa/inet.h>
 #include <cstring>
 #include <iostream>
@@ -31,6 +32,7 @@ void MulticastMessageHeader::unpack(const uint8_t* buffer)
 // ReutersMulticastPublisher implementation
 ReutersMulticastPublisher::ReutersMulticastPublisher(const ReutersMulticastConfig& config)
     : config_(config)
+    , control_packet_(MAX_PACKET_SIZE)
 {
     stats_.start_time = std::chrono::steady_clock::now();
     last_heartbeat_ = stats_.start_time;
@@ -99,14 +101,6 @@ bool ReutersMulticastPublisher::initialize()
             channel_transports_a_[channel.channel_id] = std::move(transport);
             sequence_numbers_[channel.channel_id] = 0;
             channel_enabled_[channel.channel_id] = true;
-
-            // Build instrument to channel mapping
-            for (const auto& symbol : channel.instruments) {
-                // Note: In real implementation, would need proper instrument ID lookup
-                // For now, using simple hash of symbol as ID
-                uint32_t instrument_id = std::hash<std::string> {}(symbol) & 0xFFFF;
-                instrument_channel_map_[instrument_id] = channel.channel_id;
-            }
         }
 
         for (const auto& channel : config_.channel_feeds_b) {
@@ -125,6 +119,46 @@ bool ReutersMulticastPublisher::initialize()
         // Initialize global sequence number
         sequence_numbers_[0] = 0;
 
+        // Resolve the send path of every channel once
+        routes_.clear();
+        routes_.resize(1 + config_.channel_feeds_a.size());
+        routes_[0].feed_a = incremental_transport_a_.get();
+        routes_[0].feed_b = incremental_transport_b_.get();
+        routes_[0].sequence = &sequence_numbers_[0];
+        instrument_routes_.clear();
+        for (size_t i = 0; i < config_.channel_feeds_a.size(); ++i) {
+            const auto& channel = config_.channel_feeds_a[i];
+            FeedRoute& route = routes_[i + 1];
+            route.channel_id = channel.channel_id;
+            route.feed_a = channel_transports_a_[channel.channel_id].get();
+            auto feed_b = channel_transports_b_.find(channel.channel_id);
+            route.feed_b = feed_b != channel_transports_b_.end() ? feed_b->second.get() : nullptr;
+            route.sequence = &sequence_numbers_[channel.channel_id];
+            route.enabled = &channel_enabled_[channel.channel_id];
+
+            instrument_routes_.reserve(instrument_routes_.size() + channel.instrument_ids.size());
+            for (uint32_t instrument_id : channel.instrument_ids) {
+                instrument_routes_[instrument_id] = static_cast<uint32_t>(i + 1);
+            }
+        }
+        for (auto& route : routes_) {
+            route.packet.resize(MAX_PACKET_SIZE);
+            route.pending.reserve(MAX_PENDING_UPDATES);
+            route.batch.reserve(MAX_PENDING_UPDATES);
+            route.batched.reserve(MAX_PENDING_UPDATES);
+        }
+        packet_limit_ = MAX_PACKET_SIZE;
+        if (config_.packet_mtu > 0) {
+            packet_limit_ = std::max<size_t>(PACKET_HEADER_SIZE + 1, std::min<size_t>(config_.packet_mtu, MAX_PACKET_SIZE));
+        }
+        packet_max_latency_ = std::chrono::microseconds(config_.packet_max_latency_us);
+        quote_batch_entries_ = std::max<size_t>(1, ReutersEncoder::incremental_message_entries(
+            market_core::MarketEvent::QUOTE_UPDATE, packet_limit_ - PACKET_HEADER_SIZE));
+        trade_batch_entries_ = std::max<size_t>(1, ReutersEncoder::incremental_message_entries(
+            market_core::MarketEvent::TRADE, packet_limit_ - PACKET_HEADER_SIZE));
+        snapshot_limit_ = config_.packet_mtu > 0 ? packet_limit_ : SNAPSHOT_PACKET_SIZE;
+        snapshot_fragment_entries_ = std::max<size_t>(1, ReutersEncoder::snapshot_fragment_entries(snapshot_limit_ - PACKET_HEADER_SIZE));
+
         std::cout << "Reuters multicast publisher initialized:" << std::endl;
         std::cout << "  Incremental Feed A: " << config_.incremental_feed_a.multicast_ip
                   << ":" << config_.incremental_feed_a.port << std::endl;
@@ -135,6 +169,10 @@ bool ReutersMulticastPublisher::initialize()
         std::cout << "  Snapshots: " << config_.snapshot_feed.multicast_ip
                   << ":" << config_.snapshot_feed.port << std::endl;
         std::cout << "  Channel feeds: " << config_.channel_feeds_a.size() << " channels" << std::endl;
+        if (config_.packet_mtu > 0) {
+            std::cout << "  Packing: up to " << packet_limit_ << " bytes, "
+                      << config_.packet_max_latency_us << "us max latency" << std::endl;
+        }
 
         return true;
     } catch (const std::exception& e) {
@@ -145,10 +183,13 @@ bool ReutersMulticastPublisher::initialize()
 
 void ReutersMulticastPublisher::shutdown()
 {
-    // Send end-of-stream messages
+    // Send what is still batched, then end-of-stream messages
+    flush_incremental();
     send_end_of_conflation();
 
-    // Close all sockets
+    // Close all sockets; routes point into them
+    routes_.clear();
+    instrument_routes_.clear();
     incremental_transport_a_.reset();
     incremental_transport_b_.reset();
     security_def_transport_.reset();
@@ -159,79 +200,253 @@ void ReutersMulticastPublisher::shutdown()
 
 void ReutersMulticastPublisher::publish_incremental(const market_core::QuoteEvent& quote)
 {
-    // Encode the quote update
-    auto message = ReutersEncoder::encode_market_data_incremental(quote);
+    market_core::MarketEventRecord record;
+    market_core::to_record(quote, record);
+    publish_incremental(record);
+}
 
-    // Get channel for this instrument
-    int channel_id = get_channel_for_instrument(quote.instrument_id);
+void ReutersMulticastPublisher::publish_incremental(const market_core::TradeEvent& trade)
+{
+    market_core::MarketEventRecord record;
+    market_core::to_record(trade, record);
+    publish_incremental(record);
+}
 
-    if (channel_id > 0 && channel_enabled_[channel_id]) {
-        // Send to channel-specific feeds
-        send_to_channel_feeds(message, channel_id);
-    } else {
-        // Send to global feeds
-        send_to_both_feeds(message, 0);
+void ReutersMulticastPublisher::publish_incremental(const market_core::MarketEventRecord& record)
+{
+    FeedRoute* route = route_for(record.instrument_id);
+    if (!route) {
+        return;
     }
 
-    stats_.messages_sent_a++;
-    stats_.messages_sent_b++;
-    stats_.bytes_sent += message.size() * 2;
+    if (config_.batch_window_us == 0) {
+        // Encode the quote update or trade straight after the packet header
+        const market_core::MarketEventRecord* records = &record;
+        send_incremental(*route, &records, 1);
+        return;
+    }
+
+    // A window that ran out while nothing was published is closed first
+    if (!route->pending.empty()
+        && std::chrono::steady_clock::now() - route->pending_since >= std::chrono::microseconds(config_.batch_window_us)) {
+        flush_route(*route);
+    }
+    queue_incremental(*route, record);
 }
 
-void ReutersMulticastPublisher::publish_incremental(const market_core::TradeEvent& trade)
+void ReutersMulticastPublisher::publish_incremental(const market_core::MarketEventRecord* records, size_t count)
 {
-    // Encode the trade
-    auto message = ReutersEncoder::encode_market_data_incremental(trade);
-
-    // Get channel for this instrument
-    int channel_id = get_channel_for_instrument(trade.instrument_id);
-
-    if (channel_id > 0 && channel_enabled_[channel_id]) {
-        send_to_channel_feeds(message, channel_id);
-    } else {
-        send_to_both_feeds(message, 0);
+    for (size_t i = 0; i < count; ++i) {
+        if (FeedRoute* route = route_for(records[i].instrument_id)) {
+            queue_incremental(*route, records[i]);
+        }
+    }
+    if (config_.batch_window_us == 0) {
+        for (auto& route : routes_) {
+            if (!route.pending.empty()) {
+                flush_route(route);
+            }
+        }
     }
+}
 
-    stats_.messages_sent_a++;
-    stats_.messages_sent_b++;
-    stats_.bytes_sent += message.size() * 2;
+void ReutersMulticastPublisher::flush_incremental(bool expired_only)
+{
+    auto now = std::chrono::steady_clock::now();
+    for (auto& route : routes_) {
+        if (!route.pending.empty()
+            && (!expired_only || now - route.pending_since >= std::chrono::microseconds(config_.batch_window_us))) {
+            flush_route(route);
+        }
+        if (route.packet_length > 0 && (!expired_only || now - route.packet_opened >= packet_max_latency_)) {
+            flush_packet(route);
+        }
+    }
 }
 
-void ReutersMulticastPublisher::publish_snapshot(const market_core::SnapshotEvent& snapshot)
+size_t ReutersMulticastPublisher::publish_snapshot(const market_core::SnapshotEvent& snapshot)
 {
-    // Encode the snapshot
-    auto message = ReutersEncoder::encode_market_data_snapshot(snapshot);
+    auto copy_levels = [](const std::vector<market_core::QuoteEvent>& quotes, std::vector<market_core::PriceLevel>& levels) {
+        levels.clear();
+        for (const auto& quote : quotes) {
+            levels.push_back({ quote.price, quote.quantity, quote.timestamp_ns, quote.order_count, quote.contributor_id, quote.price_level });
+        }
+    };
+    copy_levels(snapshot.bid_levels, snapshot_bids_);
+    copy_levels(snapshot.ask_levels, snapshot_asks_);
+
+    SnapshotBookView view;
+    view.instrument_id = snapshot.instrument_id;
+    view.rpt_seq = snapshot.sequence_number;
+    view.transact_time = snapshot.timestamp_ns;
+    view.last_msg_seq_num_processed = incremental_sequence(snapshot.instrument_id);
+    view.bids = snapshot_bids_.data();
+    view.bid_count = snapshot_bids_.size();
+    view.asks = snapshot_asks_.data();
+    view.ask_count = snapshot_asks_.size();
+    return publish_snapshot(view);
+}
 
-    // Add multicast header with sequence number
-    uint64_t seq = get_next_sequence_number(0);
-    auto packet = add_sequence_header(message, seq, 0);
+size_t ReutersMulticastPublisher::publish_snapshot(const market_core::OrderBook& book, size_t max_levels)
+{
+    snapshot_bids_.clear();
+    snapshot_asks_.clear();
+    book.visit_bids(max_levels, [this](const market_core::PriceLevel& level) { snapshot_bids_.push_back(level); });
+    book.visit_asks(max_levels, [this](const market_core::PriceLevel& level) { snapshot_asks_.push_back(level); });
+
+    SnapshotBookView view;
+    view.instrument_id = book.get_instrument_id();
+    view.rpt_seq = book.get_last_sequence();
+    view.transact_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    view.last_msg_seq_num_processed = incremental_sequence(view.instrument_id);
+    view.bids = snapshot_bids_.data();
+    view.bid_count = snapshot_bids_.size();
+    view.asks = snapshot_asks_.data();
+    view.ask_count = snapshot_asks_.size();
+    return publish_snapshot(view);
+}
 
-    // Send snapshots only on the snapshot feed
-    if (snapshot_transport_) {
-        snapshot_transport_->send(packet);
+size_t ReutersMulticastPublisher::publish_snapshot(const SnapshotBookView& book)
+{
+    if (routes_.empty()) {
+        return 0;
     }
 
+    // Fill each fragment up to the packet limit; an empty book is one
+    // fragment without entries
+    size_t total = book.entry_count();
+    size_t first = 0;
+    size_t packets = 0;
+    do {
+        size_t count = std::min(snapshot_fragment_entries_, total - first);
+        size_t length = ReutersEncoder::encode_market_data_snapshot(
+            book, first, count, control_packet_.data(), PACKET_HEADER_SIZE, snapshot_limit_);
+        if (length == 0) {
+            break; // Limit below one entry; never send an oversized datagram
+        }
+
+        size_t packet_length = PACKET_HEADER_SIZE + length;
+        write_packet_header(control_packet_.data(), ++snapshot_sequence_, packet_length);
+
+        // Send snapshots only on the snapshot feed
+        if (snapshot_transport_) {
+            snapshot_transport_->send(control_packet_.data(), packet_length);
+        }
+        stats_.bytes_sent += packet_length;
+        ++packets;
+        first += count;
+    } while (first < total);
+
     stats_.snapshots_sent++;
-    stats_.bytes_sent += packet.size();
+    stats_.snapshot_packets += packets;
     last_snapshot_ = std::chrono::steady_clock::now();
+    return packets;
 }
 
 void ReutersMulticastPublisher::publish_security_definition(const market_core::Instrument& instrument)
 {
-    // Encode the security definition
-    auto message = ReutersEncoder::encode_security_definition(instrument);
+    update_security_definition(instrument);
+    auto it = definition_index_.find(instrument.instrument_id);
+    if (it != definition_index_.end()) {
+        send_definition(definitions_[it->second]);
+    }
+}
+
+bool ReutersMulticastPublisher::update_security_definition(const market_core::Instrument& instrument)
+{
+    uint64_t fingerprint = ReutersEncoder::security_definition_fingerprint(instrument);
+    auto it = definition_index_.find(instrument.instrument_id);
+    if (it != definition_index_.end() && definitions_[it->second].fingerprint == fingerprint) {
+        return false;
+    }
+
+    // Encode in the control packet, then keep the bytes. A changed entry is
+    // rewritten in place unless the new encoding is longer.
+    size_t length = ReutersEncoder::encode_security_definition(
+        instrument, control_packet_.data(), PACKET_HEADER_SIZE, control_packet_.size());
+    if (length == 0) {
+        return false;
+    }
+    const uint8_t* encoded = control_packet_.data() + PACKET_HEADER_SIZE;
+
+    if (it == definition_index_.end()) {
+        size_t offset = definition_bytes_.size();
+        definition_bytes_.insert(definition_bytes_.end(), encoded, encoded + length);
+        definition_index_[instrument.instrument_id] = static_cast<uint32_t>(definitions_.size());
+        definitions_.push_back({ instrument.instrument_id, static_cast<uint32_t>(length), offset, fingerprint });
+        return true;
+    }
+
+    CachedDefinition& definition = definitions_[it->second];
+    if (length > definition.length) {
+        definition.offset = definition_bytes_.size();
+        definition_bytes_.insert(definition_bytes_.end(), encoded, encoded + length);
+    } else {
+        memcpy(definition_bytes_.data() + definition.offset, encoded, length);
+    }
+    definition.length = static_cast<uint32_t>(length);
+    definition.fingerprint = fingerprint;
+    return true;
+}
+
+size_t ReutersMulticastPublisher::rebroadcast_security_definitions(std::chrono::steady_clock::time_point now)
+{
+    if (routes_.empty() || definitions_.empty() || config_.security_definition_interval_seconds == 0) {
+        return 0;
+    }
+    auto interval = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::seconds(config_.security_definition_interval_seconds));
+    if (!definition_cycle_started_) {
+        definition_cycle_started_ = true;
+        definition_cycle_start_ = now;
+        definition_cursor_ = 0;
+    }
+
+    size_t sent = 0;
+    size_t count = definitions_.size();
+    auto elapsed = now - definition_cycle_start_;
+    if (elapsed >= interval) {
+        // Finish the cycle, then start the next one on schedule, or now if
+        // the caller fell more than a cycle behind
+        while (definition_cursor_ < count) {
+            send_definition(definitions_[definition_cursor_++]);
+            ++sent;
+        }
+        definition_cycle_start_ += interval;
+        if (now - definition_cycle_start_ >= interval) {
+            definition_cycle_start_ = now;
+        }
+        definition_cursor_ = 0;
+        elapsed = now - definition_cycle_start_;
+    }
+
+    auto due = static_cast<size_t>(static_cast<uint64_t>(elapsed.count()) * count / static_cast<uint64_t>(interval.count()));
+    while (definition_cursor_ < std::min(due, count)) {
+        send_definition(definitions_[definition_cursor_++]);
+        ++sent;
+    }
+    return sent;
+}
+
+void ReutersMulticastPublisher::send_definition(const CachedDefinition& definition)
+{
+    if (routes_.empty()) {
+        return;
+    }
 
-    // Add multicast header
-    uint64_t seq = get_next_sequence_number(0);
-    auto packet = add_sequence_header(message, seq, 0);
+    // Copy the cached message behind a fresh packet header
+    size_t packet_length = PACKET_HEADER_SIZE + definition.length;
+    memcpy(control_packet_.data() + PACKET_HEADER_SIZE, definition_bytes_.data() + definition.offset, definition.length);
+    write_packet_header(control_packet_.data(), ++definition_sequence_, packet_length);
 
     // Send on security definition feed
     if (security_def_transport_) {
-        security_def_transport_->send(packet);
+        security_def_transport_->send(control_packet_.data(), packet_length);
     }
 
     stats_.definitions_sent++;
-    stats_.bytes_sent += packet.size();
+    stats_.bytes_sent += packet_length;
 }
 
 void ReutersMulticastPublisher::publish_statistics(const market_core::StatisticsEvent& stats)
@@ -242,15 +457,16 @@ void ReutersMulticastPublisher::publish_statistics(const market_core::Statistics
 
 void ReutersMulticastPublisher::send_heartbeat()
 {
-    auto message = ReutersEncoder::encode_heartbeat();
-
-    // Send heartbeat on all active channels
-    send_to_both_feeds(message, 0);
-
-    for (const auto& [channel_id, enabled] : channel_enabled_) {
-        if (enabled) {
-            send_to_channel_feeds(message, channel_id);
+    // Send heartbeat on the global feeds and all active channels
+    for (auto& route : routes_) {
+        if (route.enabled && !route.enabled->load(std::memory_order_relaxed)) {
+            continue;
         }
+        // Heartbeats close the packet they join
+        append_message(route, [](uint8_t* buffer, size_t offset, size_t capacity) {
+            return ReutersEncoder::encode_heartbeat(buffer, offset, capacity);
+        });
+        flush_packet(route);
     }
 
     stats_.heartbeats_sent++;
@@ -260,10 +476,12 @@ void ReutersMulticastPublisher::send_heartbeat()
 void ReutersMulticastPublisher::send_end_of_conflation()
 {
     // Send end-of-conflation marker if using conflation
-    if (config_.conflation_interval_ms > 0) {
+    if (config_.conflation_interval_ms > 0 && !routes_.empty()) {
+        flush_packet(routes_[0]);
+
         // Create end-of-conflation message
         MulticastMessageHeader header;
-        header.sequence_number = get_next_sequence_number(0);
+        header.sequence_number = routes_[0].sequence->load(std::memory_order_relaxed) + 1;
         header.channel_id = 0;
         header.send_time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
             std::chrono::system_clock::now().time_since_epoch())
@@ -271,10 +489,8 @@ void ReutersMulticastPublisher::send_end_of_conflation()
         header.message_count = 0;
         header.flags = 0x02; // End-of-stream flag
 
-        std::vector<uint8_t> packet(MulticastMessageHeader::SIZE);
-        header.pack(packet.data());
-
-        send_to_both_feeds(packet, 0);
+        header.pack(routes_[0].packet.data() + PACKET_HEADER_SIZE);
+        send_packet(routes_[0], PACKET_HEADER_SIZE + MulticastMessageHeader::SIZE);
     }
 }
 
@@ -285,9 +501,9 @@ uint64_t ReutersMulticastPublisher::get_next_sequence_number(int channel_id)
 
 int ReutersMulticastPublisher::get_channel_for_instrument(uint32_t instrument_id) const
 {
-    auto it = instrument_channel_map_.find(instrument_id);
-    if (it != instrument_channel_map_.end()) {
-        return it->second;
+    auto it = instrument_routes_.find(instrument_id);
+    if (it != instrument_routes_.end()) {
+        return routes_[it->second].channel_id;
     }
     return 0; // Global channel
 }
@@ -306,72 +522,197 @@ bool ReutersMulticastPublisher::is_channel_enabled(int channel_id) const
     return false;
 }
 
-void ReutersMulticastPublisher::send_to_both_feeds(const std::vector<uint8_t>& message, int channel_id)
+uint64_t ReutersMulticastPublisher::incremental_sequence(uint32_t instrument_id)
+{
+    FeedRoute* route = route_for(instrument_id);
+    if (!route) {
+        return 0;
+    }
+    // Updates held back by batching or packing are already in the book, so
+    // they get their MsgSeqNum before a snapshot claims to include them
+    if (!route->pending.empty()) {
+        flush_route(*route);
+    }
+    if (route->packet_length > 0) {
+        flush_packet(*route);
+    }
+    return route->sequence->load(std::memory_order_relaxed);
+}
+
+ReutersMulticastPublisher::FeedRoute* ReutersMulticastPublisher::route_for(uint32_t instrument_id)
+{
+    if (routes_.empty()) {
+        return nullptr;
+    }
+    auto it = instrument_routes_.find(instrument_id);
+    if (it != instrument_routes_.end()) {
+        FeedRoute& route = routes_[it->second];
+        if (route.enabled->load(std::memory_order_relaxed)) {
+            return &route;
+        }
+    }
+    // Disabled channels fall back to the global feeds
+    return &routes_[0];
+}
+
+void ReutersMulticastPublisher::send_packet(FeedRoute& route, size_t length)
 {
-    // Add sequence header
-    uint64_t seq = get_next_sequence_number(channel_id);
-    auto packet = add_sequence_header(message, seq, channel_id);
+    write_packet_header(route.packet.data(), ++*route.sequence, length);
 
     // Send to both A and B feeds for redundancy
-    if (incremental_transport_a_) {
-        incremental_transport_a_->send(packet);
+    if (route.feed_a) {
+        route.feed_a->send(route.packet.data(), length);
+        stats_.bytes_sent += length;
+    }
+    if (route.feed_b) {
+        route.feed_b->send(route.packet.data(), length);
+        stats_.bytes_sent += length;
     }
+}
 
-    if (incremental_transport_b_) {
-        incremental_transport_b_->send(packet);
+template <typename Encode>
+bool ReutersMulticastPublisher::append_message(FeedRoute& route, Encode encode)
+{
+    bool packing = config_.packet_mtu > 0;
+    std::chrono::steady_clock::time_point now;
+    if (packing) {
+        now = std::chrono::steady_clock::now();
+        if (route.packet_length > 0 && now - route.packet_opened >= packet_max_latency_) {
+            flush_packet(route);
+        }
     }
+
+    size_t offset = route.packet_length > 0 ? route.packet_length : PACKET_HEADER_SIZE;
+    size_t length = encode(route.packet.data(), offset, packet_limit_);
+    if (length == 0 && route.packet_length > 0) {
+        // No room left: send the packet and start the next one
+        flush_packet(route);
+        offset = PACKET_HEADER_SIZE;
+        length = encode(route.packet.data(), offset, packet_limit_);
+    }
+    if (length == 0) {
+        // A single update larger than the MTU on its own
+        length = encode(route.packet.data(), offset, route.packet.size());
+        if (length == 0) {
+            return false;
+        }
+    }
+
+    if (route.packet_length == 0) {
+        route.packet_opened = now;
+    }
+    route.packet_length = offset + length;
+    route.packet_count++;
+    if (!packing || route.packet_length >= packet_limit_) {
+        flush_packet(route);
+    }
+    return true;
 }
 
-void ReutersMulticastPublisher::send_to_channel_feeds(const std::vector<uint8_t>& message, int channel_id)
+void ReutersMulticastPublisher::flush_packet(FeedRoute& route)
 {
-    // Add sequence header
-    uint64_t seq = get_next_sequence_number(channel_id);
-    auto packet = add_sequence_header(message, seq, channel_id);
+    if (route.packet_length == 0) {
+        return;
+    }
+    send_packet(route, route.packet_length);
 
-    // Send to channel-specific A feed
-    auto it_a = channel_transports_a_.find(channel_id);
-    if (it_a != channel_transports_a_.end() && it_a->second) {
-        it_a->second->send(packet);
+    stats_.packets_sent++;
+    stats_.packet_messages += route.packet_count;
+    stats_.packet_bytes += route.packet_length;
+    route.packet_length = 0;
+    route.packet_count = 0;
+}
+
+void ReutersMulticastPublisher::send_incremental(
+    FeedRoute& route, const market_core::MarketEventRecord* const* records, size_t count)
+{
+    bool appended = append_message(route, [records, count](uint8_t* buffer, size_t offset, size_t capacity) {
+        return ReutersEncoder::encode_market_data_incremental(records, count, buffer, offset, capacity);
+    });
+    if (!appended) {
+        return;
     }
 
-    // Send to channel-specific B feed
-    auto it_b = channel_transports_b_.find(channel_id);
-    if (it_b != channel_transports_b_.end() && it_b->second) {
-        it_b->second->send(packet);
+    stats_.messages_sent_a++;
+    if (route.feed_b) {
+        stats_.messages_sent_b++;
     }
+    stats_.entries_sent += count;
 }
 
-std::vector<uint8_t> ReutersMulticastPublisher::add_sequence_header(
-    const std::vector<uint8_t>& message,
-    uint64_t sequence,
-    int channel_id)
+void ReutersMulticastPublisher::queue_incremental(FeedRoute& route, const market_core::MarketEventRecord& record)
 {
-    // Thomson Reuters Binary Packet Header (20 bytes) - Chapter 6.1 of spec
-    // All fields are little-endian as per Thomson Reuters specification
-    constexpr size_t TR_HEADER_SIZE = 20;
+    if (record.type != market_core::MarketEvent::QUOTE_UPDATE && record.type != market_core::MarketEvent::TRADE) {
+        return;
+    }
+    if (route.pending.empty()) {
+        route.pending_since = std::chrono::steady_clock::now();
+    }
+    route.pending.push_back(record);
+    if (route.pending.size() >= MAX_PENDING_UPDATES) {
+        flush_route(route);
+    }
+}
 
-    // Create packet with TR header + SBE message
-    std::vector<uint8_t> packet(TR_HEADER_SIZE + message.size());
+void ReutersMulticastPublisher::flush_route(FeedRoute& route)
+{
+    // Walk the pending updates in arrival order. Each one not yet sent
+    // starts a message and pulls in the later updates of its instrument for
+    // as long as they continue it: same type and, for quotes, the next
+    // rptSeq. Anything else for that instrument waits for its own turn, so
+    // every instrument keeps its order; only instruments interleave. A run
+    // longer than one packet holds goes out as several messages.
+    size_t count = route.pending.size();
+    route.batched.assign(count, 0);
+    for (size_t i = 0; i < count; ++i) {
+        if (route.batched[i]) {
+            continue;
+        }
+        const market_core::MarketEventRecord& first = route.pending[i];
+        size_t limit = first.type == market_core::MarketEvent::QUOTE_UPDATE ? quote_batch_entries_ : trade_batch_entries_;
+        const market_core::MarketEventRecord* last = &first;
+        route.batch.clear();
+        route.batch.push_back(&first);
+        for (size_t j = i + 1; j < count; ++j) {
+            const market_core::MarketEventRecord& next = route.pending[j];
+            if (route.batched[j] || next.instrument_id != first.instrument_id) {
+                continue;
+            }
+            if (next.type != first.type
+                || (next.type == market_core::MarketEvent::QUOTE_UPDATE
+                    && next.sequence_number != last->sequence_number + 1)) {
+                break;
+            }
+            if (route.batch.size() == limit) {
+                send_incremental(route, route.batch.data(), route.batch.size());
+                route.batch.clear();
+            }
+            route.batch.push_back(&next);
+            route.batched[j] = 1;
+            last = &next;
+        }
+        send_incremental(route, route.batch.data(), route.batch.size());
+    }
+    route.pending.clear();
+}
 
-    // Build Thomson Reuters header fields
+void ReutersMulticastPublisher::write_packet_header(uint8_t* packet, uint64_t sequence, size_t length)
+{
+    // Thomson Reuters Binary Packet Header (20 bytes) - Chapter 6.1 of spec
+    // All fields are little-endian as per Thomson Reuters specification
     uint64_t msg_seq_num = sequence;
     uint64_t sending_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::system_clock::now().time_since_epoch()).count();
-    uint8_t hdr_len = TR_HEADER_SIZE;  // Always 20
-    uint8_t hdr_ver = 1;                // Version 1
-    uint16_t packet_len = packet.size(); // Total packet length including header
+    uint8_t hdr_len = PACKET_HEADER_SIZE;  // Always 20
+    uint8_t hdr_ver = 1;                   // Version 1
+    auto packet_len = static_cast<uint16_t>(length); // Total packet length including header
 
     // Pack header in little-endian format (Thomson Reuters uses little-endian)
-    memcpy(packet.data(), &msg_seq_num, 8);      // Offset 0: MsgSeqNum (8 bytes)
-    memcpy(packet.data() + 8, &sending_time, 8); // Offset 8: SendingTime (8 bytes)
-    packet[16] = hdr_len;                         // Offset 16: HdrLen (1 byte)
-    packet[17] = hdr_ver;                         // Offset 17: HdrVer (1 byte)
-    memcpy(packet.data() + 18, &packet_len, 2);  // Offset 18: PacketLen (2 bytes)
-
-    // Copy SBE message after header
-    memcpy(packet.data() + TR_HEADER_SIZE, message.data(), message.size());
-
-    return packet;
+    memcpy(packet, &msg_seq_num, 8);      // Offset 0: MsgSeqNum (8 bytes)
+    memcpy(packet + 8, &sending_time, 8); // Offset 8: SendingTime (8 bytes)
+    packet[16] = hdr_len;                 // Offset 16: HdrLen (1 byte)
+    packet[17] = hdr_ver;                 // Offset 17: HdrVer (1 byte)
+    memcpy(packet + 18, &packet_len, 2);  // Offset 18: PacketLen (2 bytes)
 }
 
 } // namespace reuters_protocol
\ No newline at end of file
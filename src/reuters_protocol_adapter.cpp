@@ -44,9 +44,13 @@ void ReutersProtocolAdapter::run_once()
     if (!running_)
         return;
 
+    // Send incremental batches whose window has run out
+    if (multicast_publisher_) {
+        multicast_publisher_->flush_incremental(true);
+    }
+
     // Send multicast heartbeats if needed
     static auto last_heartbeat = std::chrono::steady_clock::now();
-    static auto last_security_definitions = std::chrono::steady_clock::now();
     auto now = std::chrono::steady_clock::now();
 
     if (std::chrono::duration_cast<std::chrono::seconds>(now - last_heartbeat).count() >= 30) {
@@ -56,13 +60,9 @@ void ReutersProtocolAdapter::run_once()
         }
     }
 
-    // Send security definitions every 10 seconds for late-joining clients
-    if (std::chrono::duration_cast<std::chrono::seconds>(now - last_security_definitions).count() >= 10) {
-        if (multicast_publisher_ && instruments_) {
-            std::cout << "Sending periodic security definitions..." << std::endl;
-            send_security_definitions(*instruments_);
-            last_security_definitions = now;
-        }
+    // Rebroadcast security definitions for late-joining clients, a few at a time
+    if (multicast_publisher_) {
+        multicast_publisher_->rebroadcast_security_definitions(now);
     }
 }
 
@@ -73,6 +73,7 @@ void ReutersProtocolAdapter::shutdown()
     // Shutdown multicast publisher
     if (multicast_publisher_) {
         multicast_publisher_->shutdown();
+        final_publisher_stats_ = multicast_publisher_->get_statistics();
         multicast_publisher_.reset();
     }
 }
@@ -117,24 +118,75 @@ void ReutersProtocolAdapter::on_market_event(
     }
 }
 
-void ReutersProtocolAdapter::send_security_definitions(
-    const std::vector<market_core::Instrument>& instruments)
+void ReutersProtocolAdapter::on_market_event(
+    const market_core::MarketEventRecord& record)
 {
     if (!running_ || !multicast_publisher_)
         return;
 
-    // Store instruments for periodic sending
-    if (!instruments_) {
-        instruments_ = std::make_unique<std::vector<market_core::Instrument>>(instruments);
-        std::cout << "Storing " << instruments.size() << " instruments for periodic security definition updates" << std::endl;
+    stats_.market_events_processed++;
+
+    // Publish to UTP multicast channels only
+    switch (record.type) {
+    case market_core::MarketEvent::QUOTE_UPDATE:
+    case market_core::MarketEvent::TRADE:
+        multicast_publisher_->publish_incremental(record);
+        break;
+    case market_core::MarketEvent::STATISTICS: {
+        // Rare enough that the event form is fine
+        auto stats = std::static_pointer_cast<market_core::StatisticsEvent>(market_core::to_event(record));
+        multicast_publisher_->publish_statistics(*stats);
+        break;
+    }
+    default:
+        break;
     }
+}
 
-    std::cout << "Sending security definitions for " << instruments.size() << " instruments via UTP multicast" << std::endl;
+void ReutersProtocolAdapter::on_market_events(
+    const market_core::MarketEventRecord* records, size_t count)
+{
+    if (!running_ || !multicast_publisher_)
+        return;
+
+    stats_.market_events_processed += count;
+
+    // Quotes and trades of one instrument share a message
+    multicast_publisher_->publish_incremental(records, count);
+    for (size_t i = 0; i < count; ++i) {
+        if (records[i].type == market_core::MarketEvent::STATISTICS) {
+            auto stats = std::static_pointer_cast<market_core::StatisticsEvent>(market_core::to_event(records[i]));
+            multicast_publisher_->publish_statistics(*stats);
+        }
+    }
+}
+
+void ReutersProtocolAdapter::publish_book_snapshot(const market_core::OrderBook& book, size_t max_levels)
+{
+    if (!running_ || !multicast_publisher_)
+        return;
 
+    multicast_publisher_->publish_snapshot(book, max_levels);
+}
+
+void ReutersProtocolAdapter::send_security_definitions(
+    const std::vector<market_core::Instrument>& instruments)
+{
+    if (!running_ || !multicast_publisher_)
+        return;
+
+    // Only new or changed instruments go out now; the publisher keeps them
+    // all for the periodic rebroadcast
+    size_t sent = 0;
     for (const auto& instrument : instruments) {
-        multicast_publisher_->publish_security_definition(instrument);
-        std::cout << "Sent SecurityDefinition for " << instrument.primary_symbol << " (ID: " << instrument.instrument_id << ")" << std::endl;
+        if (multicast_publisher_->update_security_definition(instrument)) {
+            multicast_publisher_->publish_security_definition(instrument);
+            ++sent;
+        }
     }
+
+    std::cout << "Sent " << sent << " new or changed security definitions via UTP multicast ("
+              << multicast_publisher_->security_definition_count() << " cached)" << std::endl;
 }
 
 } // namespace reuters_protocol
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include "../include/reuters_server_config.h"
+#include "../include/common/json.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace reuters_protocol {
+
+using protocol_common::JsonValue;
+
+static MulticastChannelConfig make_feed(const std::string& ip, uint16_t port, int channel_id)
+{
+    MulticastChannelConfig feed;
+    feed.multicast_ip = ip;
+    feed.port = port;
+    feed.interface_ip = "0.0.0.0";
+    feed.channel_id = channel_id;
+    return feed;
+}
+
+static std::shared_ptr<market_core::Instrument> make_fx_spot(
+    uint32_t id, const std::string& symbol, double tick_size, double price, double spread)
+{
+    auto instrument = std::make_shared<market_core::FXSpotInstrument>(id, symbol);
+    instrument->tick_size = tick_size;
+    instrument->min_price_increment = tick_size;
+    instrument->set_property("initial_price", price);
+    instrument->set_property("initial_spread", spread);
+    return instrument;
+}
+
+ServerConfig default_server_config()
+{
+    ServerConfig config;
+    ReutersMulticastConfig& multicast = config.multicast;
+
+    multicast.incremental_feed_a = make_feed("239.100.1.1", 15001, 0);
+    multicast.incremental_feed_b = make_feed("239.100.1.2", 15002, 0);
+    multicast.security_definition_feed = make_feed("239.100.1.10", 15010, 0);
+    multicast.snapshot_feed = make_feed("239.100.1.20", 15020, 0);
+
+    // Channel 1 - Major FX pairs
+    auto channel1_a = make_feed("239.100.2.1", 15101, 1);
+    channel1_a.description = "Major FX";
+    channel1_a.instruments = { "EURUSD", "GBPUSD", "USDJPY", "USDCHF" };
+    auto channel1_b = channel1_a;
+    channel1_b.multicast_ip = "239.100.2.2";
+    channel1_b.port = 15102;
+    multicast.channel_feeds_a.push_back(channel1_a);
+    multicast.channel_feeds_b.push_back(channel1_b);
+
+    // Channel 2 - Commodity currencies
+    auto channel2_a = make_feed("239.100.3.1", 15201, 2);
+    channel2_a.description = "Commodity FX";
+    channel2_a.instruments = { "AUDUSD", "NZDUSD", "USDCAD" };
+    auto channel2_b = channel2_a;
+    channel2_b.multicast_ip = "239.100.3.2";
+    channel2_b.port = 15202;
+    multicast.channel_feeds_a.push_back(channel2_a);
+    multicast.channel_feeds_b.push_back(channel2_b);
+
+    multicast.incremental_interval_ms = 100; // Slower rate: 10 events/sec instead of 100
+    multicast.snapshot_interval_seconds = 60;
+    multicast.heartbeat_interval_seconds = 30;
+    multicast.book_depth = 10;
+
+    config.instruments = {
+        make_fx_spot(1001, "EURUSD", 0.00001, 1.0850, 0.00002),
+        make_fx_spot(1002, "GBPUSD", 0.00001, 1.2650, 0.00003),
+        make_fx_spot(1003, "USDJPY", 0.001, 149.50, 0.002),
+        make_fx_spot(1004, "USDCHF", 0.00001, 0.8950, 0.00002),
+        make_fx_spot(1005, "AUDUSD", 0.00001, 0.6680, 0.00002),
+        make_fx_spot(1006, "NZDUSD", 0.00001, 0.6020, 0.00003),
+        make_fx_spot(1007, "USDCAD", 0.00001, 1.3620, 0.00002),
+    };
+    return config;
+}
+
+// Fields absent from the JSON keep the value already in feed
+static void read_feed(const JsonValue& json, MulticastChannelConfig& feed)
+{
+    feed.multicast_ip = json.string("multicast_ip", feed.multicast_ip);
+    feed.port = static_cast<uint16_t>(json.number("port", feed.port));
+    feed.interface_ip = json.string("interface_ip", feed.interface_ip);
+    feed.channel_id = static_cast<int>(json.number("channel_id", feed.channel_id));
+    feed.description = json.string("description", feed.description);
+}
+
+static market_core::InstrumentType parse_instrument_type(const std::string& name)
+{
+    if (name == "FX_SPOT") {
+        return market_core::InstrumentType::FX_SPOT;
+    }
+    if (name == "FX_FORWARD") {
+        return market_core::InstrumentType::FX_FORWARD;
+    }
+    if (name == "FUTURE") {
+        return market_core::InstrumentType::FUTURE;
+    }
+    if (name == "OPTION") {
+        return market_core::InstrumentType::OPTION;
+    }
+    if (name == "EQUITY") {
+        return market_core::InstrumentType::EQUITY;
+    }
+    throw std::runtime_error("unknown instrument type: " + name);
+}
+
+static std::shared_ptr<market_core::Instrument> read_instrument(const JsonValue& json)
+{
+    std::string symbol = json.string("symbol", "");
+    if (symbol.empty() || !json.find("id")) {
+        throw std::runtime_error("instrument needs a symbol and an id");
+    }
+
+    auto instrument = market_core::InstrumentFactory::create(
+        parse_instrument_type(json.string("type", "FX_SPOT")),
+        static_cast<uint32_t>(json.number("id", 0)),
+        symbol);
+    instrument->tick_size = json.number("tick_size", instrument->tick_size);
+    instrument->min_price_increment = instrument->tick_size;
+    instrument->description = json.string("description", "");
+    instrument->set_property("initial_price", json.number("initial_price", 100.0));
+    instrument->set_property("initial_spread", json.number("initial_spread", 2.0 * instrument->tick_size));
+    if (const JsonValue* channel = json.find("channel")) {
+        instrument->set_property("channel", static_cast<int64_t>(channel->as_number()));
+    }
+    return instrument;
+}
+
+market_core::OrderBook::Config ServerConfig::book_config() const
+{
+    market_core::OrderBook::Config config;
+    config.max_visible_levels = multicast.book_depth;
+    config.track_market_makers = true; // Enable for Reuters
+
+    bool large = instruments.size() > LARGE_UNIVERSE;
+    bool ladder = book_engine == BookEngine::TICK_LADDER || (book_engine == BookEngine::AUTO && !large);
+    config.engine = ladder ? market_core::OrderBook::Config::Engine::TICK_LADDER
+                           : market_core::OrderBook::Config::Engine::PRICE_MAP;
+    if (ladder_window_ticks > 0) {
+        config.ladder_window_ticks = ladder_window_ticks;
+    }
+    if (trade_history_capacity > 0) {
+        config.trade_history_capacity = trade_history_capacity;
+    } else if (large) {
+        config.trade_history_capacity = 16;
+    }
+    return config;
+}
+
+bool load_server_config(const std::string& path, ServerConfig& config)
+{
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        return false;
+    }
+    std::stringstream text;
+    text << file.rdbuf();
+    JsonValue root = JsonValue::parse(text.str());
+
+    if (const JsonValue* server = root.find("server")) {
+        config.tcp_port = static_cast<uint16_t>(server->number("port", config.tcp_port));
+    }
+
+    ReutersMulticastConfig& multicast = config.multicast;
+    if (const JsonValue* feeds = root.find("multicast")) {
+        if (const JsonValue* feed = feeds->find("incremental_feed_a")) {
+            read_feed(*feed, multicast.incremental_feed_a);
+        }
+        if (const JsonValue* feed = feeds->find("incremental_feed_b")) {
+            read_feed(*feed, multicast.incremental_feed_b);
+        }
+        if (const JsonValue* feed = feeds->find("security_definition_feed")) {
+            read_feed(*feed, multicast.security_definition_feed);
+        }
+        if (const JsonValue* feed = feeds->find("snapshot_feed")) {
+            read_feed(*feed, multicast.snapshot_feed);
+        }
+    }
+
+    if (const JsonValue* channels = root.find("channels")) {
+        multicast.channel_feeds_a.clear();
+        multicast.channel_feeds_b.clear();
+        for (const JsonValue& channel : channels->items()) {
+            MulticastChannelConfig base;
+            base.interface_ip = "0.0.0.0";
+            base.port = 0;
+            base.channel_id = static_cast<int>(channel.number("channel_id", 0));
+            base.description = channel.string("description", "");
+            if (const JsonValue* symbols = channel.find("instruments")) {
+                for (const JsonValue& symbol : symbols->items()) {
+                    base.instruments.push_back(symbol.as_string());
+                }
+            }
+            if (base.channel_id <= 0) {
+                throw std::runtime_error("channel needs a positive channel_id");
+            }
+
+            MulticastChannelConfig feed_a = base;
+            MulticastChannelConfig feed_b = base;
+            if (const JsonValue* feed = channel.find("feed_a")) {
+                read_feed(*feed, feed_a);
+            }
+            if (const JsonValue* feed = channel.find("feed_b")) {
+                read_feed(*feed, feed_b);
+            }
+            feed_a.channel_id = feed_b.channel_id = base.channel_id;
+            multicast.channel_feeds_a.push_back(feed_a);
+            multicast.channel_feeds_b.push_back(feed_b);
+        }
+    }
+
+    if (const JsonValue* publishing = root.find("publishing")) {
+        multicast.incremental_interval_ms = static_cast<uint32_t>(
+            publishing->number("incremental_interval_ms", multicast.incremental_interval_ms));
+        multicast.snapshot_interval_seconds = static_cast<uint32_t>(
+            publishing->number("snapshot_interval_seconds", multicast.snapshot_interval_seconds));
+        multicast.heartbeat_interval_seconds = static_cast<uint32_t>(
+            publishing->number("heartbeat_interval_seconds", multicast.heartbeat_interval_seconds));
+        multicast.security_definition_interval_seconds = static_cast<uint32_t>(
+            publishing->number("security_definition_interval_seconds", multicast.security_definition_interval_seconds));
+        multicast.batch_window_us = static_cast<uint32_t>(
+            publishing->number("batch_window_us", multicast.batch_window_us));
+        multicast.packet_mtu = static_cast<uint32_t>(
+            publishing->number("packet_mtu", multicast.packet_mtu));
+        multicast.packet_max_latency_us = static_cast<uint32_t>(
+            publishing->number("packet_max_latency_us", multicast.packet_max_latency_us));
+        multicast.send_statistics = publishing->boolean("send_statistics", multicast.send_statistics);
+    }
+
+    if (const JsonValue* book = root.find("book")) {
+        multicast.book_depth = static_cast<uint32_t>(book->number("depth", multicast.book_depth));
+        std::string engine = book->string("engine", "auto");
+        if (engine == "auto") {
+            config.book_engine = ServerConfig::BookEngine::AUTO;
+        } else if (engine == "tick_ladder") {
+            config.book_engine = ServerConfig::BookEngine::TICK_LADDER;
+        } else if (engine == "price_map") {
+            config.book_engine = ServerConfig::BookEngine::PRICE_MAP;
+        } else {
+            throw std::runtime_error("unknown book engine: " + engine);
+        }
+        config.ladder_window_ticks = static_cast<size_t>(
+            book->number("ladder_window_ticks", static_cast<double>(config.ladder_window_ticks)));
+        config.trade_history_capacity = static_cast<size_t>(
+            book->number("trade_history_capacity", static_cast<double>(config.trade_history_capacity)));
+    }
+
+    if (const JsonValue* instruments = root.find("instruments")) {
+        config.instruments.clear();
+        config.instruments.reserve(instruments->items().size());
+        for (const JsonValue& instrument : instruments->items()) {
+            config.instruments.push_back(read_instrument(instrument));
+        }
+    }
+
+    if (const JsonValue* universe = root.find("synthetic_universe")) {
+        market_core::UniverseSpec& spec = config.universe;
+        spec.count = static_cast<size_t>(universe->number("count", static_cast<double>(spec.count)));
+        spec.first_id = static_cast<uint32_t>(universe->number("first_id", spec.first_id));
+        spec.fx_spot_share = universe->number("fx_spot_share", spec.fx_spot_share);
+        spec.fx_forward_share = universe->number("fx_forward_share", spec.fx_forward_share);
+        spec.seed = static_cast<uint64_t>(universe->number("seed", static_cast<double>(spec.seed)));
+        config.assign_universe_channels = universe->boolean("assign_channels", config.assign_universe_channels);
+    }
+
+    return true;
+}
+
+void finalize_server_config(ServerConfig& config)
+{
+    ReutersMulticastConfig& multicast = config.multicast;
+
+    if (config.universe.count > 0) {
+        // Keep synthetic IDs clear of the listed ones
+        uint32_t max_listed_id = 0;
+        for (const auto& instrument : config.instruments) {
+            max_listed_id = std::max(max_listed_id, instrument->instrument_id);
+        }
+        market_core::UniverseSpec spec = config.universe;
+        if (!config.instruments.empty() && spec.first_id <= max_listed_id) {
+            spec.first_id = max_listed_id + 1;
+        }
+
+        auto universe = market_core::generate_universe(spec);
+        size_t channel_count = multicast.channel_feeds_a.size();
+        config.instruments.reserve(config.instruments.size() + universe.size());
+        for (size_t i = 0; i < universe.size(); ++i) {
+            if (config.assign_universe_channels && channel_count > 0) {
+                int channel_id = multicast.channel_feeds_a[i % channel_count].channel_id;
+                universe[i]->set_property("channel", static_cast<int64_t>(channel_id));
+            }
+            config.instruments.push_back(std::move(universe[i]));
+        }
+    }
+
+    std::unordered_map<std::string, uint32_t> ids_by_symbol;
+    std::unordered_map<int, size_t> channel_index;
+    for (size_t i = 0; i < multicast.channel_feeds_a.size(); ++i) {
+        channel_index[multicast.channel_feeds_a[i].channel_id] = i;
+        multicast.channel_feeds_a[i].instrument_ids.clear();
+        for (const auto& symbol : multicast.channel_feeds_a[i].instruments) {
+            ids_by_symbol.emplace(symbol, 0);
+        }
+    }
+
+    // Explicit "channel" on an instrument, then the channel symbol lists
+    for (const auto& instrument : config.instruments) {
+        auto symbol = ids_by_symbol.find(instrument->primary_symbol);
+        if (symbol != ids_by_symbol.end()) {
+            symbol->second = instrument->instrument_id;
+        }
+        auto channel = instrument->get_property<int64_t>("channel");
+        if (!channel) {
+            continue;
+        }
+        auto index = channel_index.find(static_cast<int>(*channel));
+        if (index != channel_index.end()) {
+            multicast.channel_feeds_a[index->second].instrument_ids.push_back(instrument->instrument_id);
+        }
+    }
+    for (auto& feed : multicast.channel_feeds_a) {
+        for (const auto& symbol : feed.instruments) {
+            uint32_t id = ids_by_symbol[symbol];
+            if (id == 0) {
+                throw std::runtime_error("channel " + std::to_string(feed.channel_id)
+                    + " lists unknown instrument " + symbol);
+            }
+            feed.instrument_ids.push_back(id);
+        }
+    }
+
+    // B feeds carry the same instruments as their A twins
+    for (auto& feed_b : multicast.channel_feeds_b) {
+        auto index = channel_index.find(feed_b.channel_id);
+        if (index != channel_index.end()) {
+            feed_b.instrument_ids = multicast.channel_feeds_a[index->second].instrument_ids;
+        }
+    }
+}
+
+} // namespace reuters_protocol
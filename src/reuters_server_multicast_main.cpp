@@ -1,14 +1,21 @@
+#include "../core/include/event_capture.h"
+#include "../core/include/load_generator.h"
 #include "../core/include/market_data_generator.h"
 #include "../core/include/order_book_manager.h"
+#include "../core/include/replay_source.h"
+#include "../core/include/scenario.h"
 #include "../include/reuters_protocol_adapter.h"
+#include "../include/reuters_server_config.h"
 #include <algorithm>
 #include <atomic>
 #include <chrono>
-#include <fstream>
 #include <iostream>
+#include <optional>
 #include <random>
 #include <signal.h>
+#include <string>
 #include <thread>
+#include <vector>
 
 std::atomic<bool> running(true);
 
@@ -18,82 +25,173 @@ void signal_handler(int signal)
     running = false;
 }
 
-// Load configuration from JSON file
-reuters_protocol::ReutersMulticastConfig load_multicast_config(const std::string& config_file)
+// Command line: [config_file] [tcp_port] [--rate=N] [--profile=steady|square|poisson]
+//               [--peak-rate=N] [--period-ms=N] [--duty=F] [--burst=N] [--duration=S]
+//               [--seed=N] [--universe=N]
+//               [--hawkes-self=F] [--hawkes-cross=F] [--hawkes-decay=PER_S]
+//               [--record=FILE] [--replay=FILE] [--replay-speed=N|max]
+//               [--scenario="NORMAL 60s, STRESSED 5s on channel 2, THIN 30s"]
+// Any of the load options switches the server into open-loop load mode;
+// --seed makes generation reproducible and --universe adds N synthetic
+// instruments on top of the configured ones. The --hawkes-* options tune
+// the excitation used by --profile=hawkes. --record captures every
+// generated event; --replay plays a capture back instead of generating,
+// at the recorded pace times --replay-speed (max = as fast as possible).
+// The replay needs the same instruments as the recording. --scenario steps
+// through market modes, globally or "on channel N", stops at the end of
+// the timeline and prints a capacity report per phase.
+struct ServerOptions {
+    std::vector<std::string> positional;
+    bool load_mode = false;
+    bool seeded = false;
+    uint64_t seed = 0;
+    size_t universe_size = 0;
+    bool universe_set = false;
+    std::optional<double> hawkes_self;
+    std::optional<double> hawkes_cross;
+    std::optional<double> hawkes_decay;
+    std::string record_path;
+    std::string replay_path;
+    double replay_speed = 1.0;
+    std::vector<market_core::ScenarioPhase> scenario;
+    market_core::LoadGenerator::Profile load_profile;
+    double duration_seconds = 0.0; // 0 = until Ctrl+C
+};
+
+static bool parse_options(int argc, char* argv[], ServerOptions& options)
 {
-    reuters_protocol::ReutersMulticastConfig config;
-
-    try {
-        std::ifstream file(config_file);
-        if (!file.is_open()) {
-            std::cerr << "Could not open config file: " << config_file << std::endl;
-            return config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg.compare(0, 2, "--") != 0) {
+            options.positional.push_back(arg);
+            continue;
         }
 
-        // For simplicity, using hardcoded config
-        // In production, would parse JSON properly
-        config.incremental_feed_a.multicast_ip = "239.100.1.1";
-        config.incremental_feed_a.port = 15001;
-        config.incremental_feed_a.interface_ip = "0.0.0.0";
-        config.incremental_feed_a.channel_id = 0;
-
-        config.incremental_feed_b.multicast_ip = "239.100.1.2";
-        config.incremental_feed_b.port = 15002;
-        config.incremental_feed_b.interface_ip = "0.0.0.0";
-        config.incremental_feed_b.channel_id = 0;
-
-        config.security_definition_feed.multicast_ip = "239.100.1.10";
-        config.security_definition_feed.port = 15010;
-        config.security_definition_feed.interface_ip = "0.0.0.0";
-
-        config.snapshot_feed.multicast_ip = "239.100.1.20";
-        config.snapshot_feed.port = 15020;
-        config.snapshot_feed.interface_ip = "0.0.0.0";
-
-        // Channel 1 - Major FX pairs
-        reuters_protocol::MulticastChannelConfig channel1_a;
-        channel1_a.multicast_ip = "239.100.2.1";
-        channel1_a.port = 15101;
-        channel1_a.interface_ip = "0.0.0.0";
-        channel1_a.channel_id = 1;
-        channel1_a.instruments = { "EURUSD", "GBPUSD", "USDJPY", "USDCHF" };
-        config.channel_feeds_a.push_back(channel1_a);
-
-        reuters_protocol::MulticastChannelConfig channel1_b;
-        channel1_b.multicast_ip = "239.100.2.2";
-        channel1_b.port = 15102;
-        channel1_b.interface_ip = "0.0.0.0";
-        channel1_b.channel_id = 1;
-        channel1_b.instruments = { "EURUSD", "GBPUSD", "USDJPY", "USDCHF" };
-        config.channel_feeds_b.push_back(channel1_b);
-
-        // Channel 2 - Commodity currencies
-        reuters_protocol::MulticastChannelConfig channel2_a;
-        channel2_a.multicast_ip = "239.100.3.1";
-        channel2_a.port = 15201;
-        channel2_a.interface_ip = "0.0.0.0";
-        channel2_a.channel_id = 2;
-        channel2_a.instruments = { "AUDUSD", "NZDUSD", "USDCAD" };
-        config.channel_feeds_a.push_back(channel2_a);
-
-        reuters_protocol::MulticastChannelConfig channel2_b;
-        channel2_b.multicast_ip = "239.100.3.2";
-        channel2_b.port = 15202;
-        channel2_b.interface_ip = "0.0.0.0";
-        channel2_b.channel_id = 2;
-        channel2_b.instruments = { "AUDUSD", "NZDUSD", "USDCAD" };
-        config.channel_feeds_b.push_back(channel2_b);
-
-        config.incremental_interval_ms = 100; // Slower rate: 10 events/sec instead of 100
-        config.snapshot_interval_seconds = 60;
-        config.heartbeat_interval_seconds = 30;
-        config.book_depth = 10;
+        auto eq = arg.find('=');
+        std::string name = arg.substr(2, eq == std::string::npos ? std::string::npos : eq - 2);
+        std::string value = eq == std::string::npos ? "" : arg.substr(eq + 1);
+
+        try {
+            if (name == "rate") {
+                options.load_profile.rate = std::stod(value);
+            } else if (name == "profile") {
+                if (!market_core::LoadGenerator::parse_shape(value, options.load_profile.shape)) {
+                    std::cerr << "Unknown load profile: " << value << std::endl;
+                    return false;
+                }
+            } else if (name == "peak-rate") {
+                options.load_profile.peak_rate = std::stod(value);
+            } else if (name == "period-ms") {
+                options.load_profile.period_ns = static_cast<uint64_t>(std::stod(value) * 1e6);
+            } else if (name == "duty") {
+                options.load_profile.duty_cycle = std::stod(value);
+            } else if (name == "burst") {
+                options.load_profile.burst_size = static_cast<uint32_t>(std::stoul(value));
+            } else if (name == "duration") {
+                options.duration_seconds = std::stod(value);
+            } else if (name == "seed") {
+                options.seed = std::stoull(value);
+                options.seeded = true;
+                continue;
+            } else if (name == "universe") {
+                options.universe_size = std::stoull(value);
+                options.universe_set = true;
+                continue;
+            } else if (name == "record") {
+                options.record_path = value;
+                continue;
+            } else if (name == "replay") {
+                options.replay_path = value;
+                continue;
+            } else if (name == "replay-speed") {
+                if (!market_core::ReplaySource::parse_speed(value, options.replay_speed)) {
+                    std::cerr << "Bad replay speed: " << value << std::endl;
+                    return false;
+                }
+                continue;
+            } else if (name == "scenario") {
+                std::string error;
+                if (!market_core::parse_scenario(value, options.scenario, error)) {
+                    std::cerr << "Bad scenario: " << error << std::endl;
+                    return false;
+                }
+                continue;
+            } else if (name == "hawkes-self") {
+                options.hawkes_self = std::stod(value);
+                continue;
+            } else if (name == "hawkes-cross") {
+                options.hawkes_cross = std::stod(value);
+                continue;
+            } else if (name == "hawkes-decay") {
+                options.hawkes_decay = std::stod(value);
+                continue;
+            } else {
+                std::cerr << "Unknown option: " << arg << std::endl;
+                return false;
+            }
+        } catch (const std::exception&) {
+            std::cerr << "Bad value for " << arg << std::endl;
+            return false;
+        }
+        options.load_mode = true;
+    }
+    return true;
+}
 
-    } catch (const std::exception& e) {
-        std::cerr << "Error loading config: " << e.what() << std::endl;
+static void print_replay_report(const market_core::ReplaySource& replay)
+{
+    auto report = replay.report();
+    std::cout << "Replay [";
+    if (replay.speed() > 0.0) {
+        std::cout << replay.speed() << "x";
+    } else {
+        std::cout << "max";
     }
+    std::cout << "]: " << report.replayed << "/" << report.total << " records"
+              << " (" << report.recorded_seconds << "s recorded) in " << report.elapsed_seconds << "s"
+              << ", rate=" << static_cast<uint64_t>(report.achieved_rate) << "/s"
+              << ", lag mean=" << static_cast<uint64_t>(report.mean_lag_ns) << "ns"
+              << " max=" << static_cast<uint64_t>(report.max_lag_ns) << "ns"
+              << std::endl;
+}
 
-    return config;
+static void print_load_report(const market_core::LoadGenerator& load)
+{
+    auto report = load.report();
+    std::cout << "Load [" << market_core::LoadGenerator::shape_name(load.profile().shape) << "]: "
+              << "target=" << static_cast<uint64_t>(report.target_rate) << "/s"
+              << ", achieved=" << static_cast<uint64_t>(report.achieved_rate) << "/s"
+              << ", sent=" << report.sent
+              << ", lag mean=" << static_cast<uint64_t>(report.mean_lag_ns) << "ns"
+              << " p99=" << static_cast<uint64_t>(report.p99_lag_ns) << "ns"
+              << " max=" << static_cast<uint64_t>(report.max_lag_ns) << "ns"
+              << ", service p50=" << static_cast<uint64_t>(report.p50_service_ns) << "ns"
+              << " p99=" << static_cast<uint64_t>(report.p99_service_ns) << "ns"
+              << ", backlog=" << static_cast<uint64_t>(report.backlog_ns) << "ns"
+              << std::endl;
+}
+
+static void print_scenario_report(const market_core::ScenarioRunner& scenario)
+{
+    std::cout << "\nScenario capacity report:" << std::endl;
+    size_t index = 0;
+    for (const auto& phase : scenario.reports()) {
+        std::cout << "  " << ++index << ". " << market_core::ScenarioRunner::describe(phase.phase)
+                  << " [" << phase.elapsed_seconds << "s]: "
+                  << "updates=" << phase.updates
+                  << ", trades=" << phase.trades
+                  << ", rate=" << static_cast<uint64_t>(phase.update_rate) << "/s";
+        if (phase.target_rate > 0.0) {
+            std::cout << " (target " << static_cast<uint64_t>(phase.target_rate) << "/s)"
+                      << ", lag p50=" << phase.lag_ns.percentile(0.5) << "ns"
+                      << " p99=" << phase.lag_ns.percentile(0.99) << "ns"
+                      << " max=" << phase.lag_ns.max() << "ns"
+                      << ", service p50=" << phase.service_ns.percentile(0.5) << "ns"
+                      << " p99=" << phase.service_ns.percentile(0.99) << "ns"
+                      << " max=" << phase.service_ns.max() << "ns";
+        }
+        std::cout << std::endl;
+    }
 }
 
 int main(int argc, char* argv[])
@@ -105,69 +203,48 @@ int main(int argc, char* argv[])
     std::cout << "Reuters FX Market Data Server with Multicast Support" << std::endl;
     std::cout << "====================================================" << std::endl;
 
+    ServerOptions options;
+    if (!parse_options(argc, argv, options)) {
+        return 1;
+    }
+
     try {
         // Initialize core market data system
         auto book_manager = std::make_shared<market_core::OrderBookManager>();
         auto data_generator = std::make_shared<market_core::MarketDataGenerator>(book_manager);
 
-        // Create FX instruments
-        std::cout << "Creating FX instruments..." << std::endl;
-
-        // Major pairs
-        auto eurusd = std::make_shared<market_core::Instrument>(1001, "EURUSD", market_core::InstrumentType::FX_SPOT);
-        eurusd->tick_size = 0.00001;
-        eurusd->set_property("initial_price", 1.0850);
-        eurusd->set_property("initial_spread", 0.00002);
-        book_manager->add_instrument(eurusd);
-
-        auto gbpusd = std::make_shared<market_core::Instrument>(1002, "GBPUSD", market_core::InstrumentType::FX_SPOT);
-        gbpusd->tick_size = 0.00001;
-        gbpusd->set_property("initial_price", 1.2650);
-        gbpusd->set_property("initial_spread", 0.00003);
-        book_manager->add_instrument(gbpusd);
-
-        auto usdjpy = std::make_shared<market_core::Instrument>(1003, "USDJPY", market_core::InstrumentType::FX_SPOT);
-        usdjpy->tick_size = 0.001;
-        usdjpy->set_property("initial_price", 149.50);
-        usdjpy->set_property("initial_spread", 0.002);
-        book_manager->add_instrument(usdjpy);
-
-        auto usdchf = std::make_shared<market_core::Instrument>(1004, "USDCHF", market_core::InstrumentType::FX_SPOT);
-        usdchf->tick_size = 0.00001;
-        usdchf->set_property("initial_price", 0.8950);
-        usdchf->set_property("initial_spread", 0.00002);
-        book_manager->add_instrument(usdchf);
-
-        // Commodity currencies
-        auto audusd = std::make_shared<market_core::Instrument>(1005, "AUDUSD", market_core::InstrumentType::FX_SPOT);
-        audusd->tick_size = 0.00001;
-        audusd->set_property("initial_price", 0.6680);
-        audusd->set_property("initial_spread", 0.00002);
-        book_manager->add_instrument(audusd);
-
-        auto nzdusd = std::make_shared<market_core::Instrument>(1006, "NZDUSD", market_core::InstrumentType::FX_SPOT);
-        nzdusd->tick_size = 0.00001;
-        nzdusd->set_property("initial_price", 0.6020);
-        nzdusd->set_property("initial_spread", 0.00003);
-        book_manager->add_instrument(nzdusd);
-
-        auto usdcad = std::make_shared<market_core::Instrument>(1007, "USDCAD", market_core::InstrumentType::FX_SPOT);
-        usdcad->tick_size = 0.00001;
-        usdcad->set_property("initial_price", 1.3620);
-        usdcad->set_property("initial_spread", 0.00002);
-        book_manager->add_instrument(usdcad);
-
-        std::cout << "Created " << book_manager->get_all_instrument_ids().size() << " FX instruments" << std::endl;
-
-        // Create order books for all instruments
-        std::cout << "Creating order books..." << std::endl;
-        market_core::OrderBook::Config book_config;
-        book_config.max_visible_levels = 10;
-        book_config.track_market_makers = true; // Enable for Reuters
-
-        for (const auto& instrument_id : book_manager->get_all_instrument_ids()) {
+        // Load configuration
+        std::string config_file = "config/reuters_config.json";
+        if (options.positional.size() > 0) {
+            config_file = options.positional[0];
+        }
+
+        auto server_config = reuters_protocol::default_server_config();
+        if (!reuters_protocol::load_server_config(config_file, server_config)) {
+            std::cerr << "Could not open config file: " << config_file << ", using built-in defaults" << std::endl;
+        }
+        if (options.universe_set) {
+            server_config.universe.count = options.universe_size;
+        }
+        if (options.positional.size() > 1) {
+            server_config.tcp_port = static_cast<uint16_t>(std::stoi(options.positional[1]));
+        }
+
+        auto startup_begin = std::chrono::steady_clock::now();
+        reuters_protocol::finalize_server_config(server_config);
+        const auto& multicast_config = server_config.multicast;
+
+        // Register instruments and their books in one pass
+        auto book_config = server_config.book_config();
+        size_t books_created = 0;
+        for (const auto& instrument : server_config.instruments) {
+            uint32_t instrument_id = instrument->instrument_id;
+            if (!book_manager->add_instrument(instrument)) {
+                std::cerr << "Duplicate instrument ID " << instrument_id << " (" << instrument->primary_symbol << ")" << std::endl;
+                continue;
+            }
             if (book_manager->create_order_book(instrument_id, book_config)) {
-                std::cout << "Created order book for instrument " << instrument_id << std::endl;
+                ++books_created;
             } else {
                 std::cerr << "Failed to create order book for instrument " << instrument_id << std::endl;
             }
@@ -175,28 +252,58 @@ int main(int argc, char* argv[])
 
         // Initialize market data
         data_generator->set_market_mode(market_core::MarketMode::NORMAL);
-        std::cout << "Generating initial market state..." << std::endl;
-        data_generator->generate_all_instruments();
+        if (options.hawkes_self || options.hawkes_cross || options.hawkes_decay) {
+            auto market_config = data_generator->get_config();
+            auto& hawkes = market_config.hawkes;
+            hawkes.self_excitation = options.hawkes_self.value_or(hawkes.self_excitation);
+            hawkes.cross_excitation = options.hawkes_cross.value_or(hawkes.cross_excitation);
+            hawkes.decay_per_second = options.hawkes_decay.value_or(hawkes.decay_per_second);
+            data_generator->set_config(market_config);
+        }
+        if (options.seeded) {
+            data_generator->set_seed(options.seed);
+            std::cout << "Deterministic generation with seed " << options.seed << std::endl;
+        }
+        // Record from the initial state on, so a replay rebuilds the same books
+        std::shared_ptr<market_core::CaptureWriter> recorder;
+        if (!options.record_path.empty()) {
+            recorder = std::make_shared<market_core::CaptureWriter>();
+            if (!recorder->open(options.record_path)) {
+                std::cerr << "Cannot write capture file " << options.record_path << std::endl;
+                return 1;
+            }
+            data_generator->add_listener(recorder);
+            std::cout << "Recording events to " << options.record_path << std::endl;
+        }
 
-        // Load multicast configuration
-        std::string config_file = "config/reuters_config.json";
-        if (argc > 1) {
-            config_file = argv[1];
+        // A replay brings its own initial state
+        std::unique_ptr<market_core::ReplaySource> replay;
+        if (!options.replay_path.empty()) {
+            replay = std::make_unique<market_core::ReplaySource>(book_manager, options.replay_speed);
+            std::string error;
+            if (!replay->open(options.replay_path, error)) {
+                std::cerr << "Cannot replay: " << error << std::endl;
+                return 1;
+            }
+        } else {
+            data_generator->generate_all_instruments();
         }
 
-        auto multicast_config = load_multicast_config(config_file);
+        auto startup_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - startup_begin)
+                              .count();
+        std::cout << "Created " << book_manager->instrument_count() << " instruments and "
+                  << books_created << " order books (" << server_config.universe.count
+                  << " synthetic) in " << startup_ms << " ms" << std::endl;
 
         // Initialize Reuters protocol adapter with multicast
-        uint16_t tcp_port = 11501;
-        if (argc > 2) {
-            tcp_port = static_cast<uint16_t>(std::stoi(argv[2]));
-        }
+        uint16_t tcp_port = server_config.tcp_port;
 
         auto reuters_adapter = std::make_unique<reuters_protocol::ReutersProtocolAdapter>(tcp_port, multicast_config);
 
         // Convert to shared_ptr for listener management
         std::shared_ptr<reuters_protocol::ReutersProtocolAdapter> reuters_shared(reuters_adapter.release());
-        data_generator->add_listener(std::weak_ptr<market_core::IMarketEventListener>(reuters_shared));
+        data_generator->add_listener(reuters_shared);
 
         // Initialize with multicast support
         if (!reuters_shared->initialize_with_multicast()) {
@@ -206,7 +313,8 @@ int main(int argc, char* argv[])
 
         // Send initial security definitions
         std::vector<market_core::Instrument> instruments;
-        for (const auto& instrument_ptr : book_manager->get_all_instruments()) {
+        instruments.reserve(server_config.instruments.size());
+        for (const auto& instrument_ptr : server_config.instruments) {
             instruments.push_back(*instrument_ptr);
         }
         reuters_shared->send_security_definitions(instruments);
@@ -223,16 +331,64 @@ int main(int argc, char* argv[])
         std::cout << "  Snapshots:     " << multicast_config.snapshot_feed.multicast_ip
                   << ":" << multicast_config.snapshot_feed.port << std::endl;
         std::cout << "\nChannel-specific feeds:" << std::endl;
-        std::cout << "  Channel 1 (Major): 239.100.2.1-2:15101-15102" << std::endl;
-        std::cout << "  Channel 2 (Commodity): 239.100.3.1-2:15201-15202" << std::endl;
+        for (size_t i = 0; i < multicast_config.channel_feeds_a.size(); ++i) {
+            const auto& feed_a = multicast_config.channel_feeds_a[i];
+            std::cout << "  Channel " << feed_a.channel_id;
+            if (!feed_a.description.empty()) {
+                std::cout << " (" << feed_a.description << ")";
+            }
+            std::cout << ": A " << feed_a.multicast_ip << ":" << feed_a.port;
+            if (i < multicast_config.channel_feeds_b.size()) {
+                const auto& feed_b = multicast_config.channel_feeds_b[i];
+                std::cout << ", B " << feed_b.multicast_ip << ":" << feed_b.port;
+            }
+            std::cout << ", " << feed_a.instrument_ids.size() << " instruments" << std::endl;
+        }
         std::cout << "\nPress Ctrl+C to shutdown" << std::endl;
         std::cout << "======================================\n"
                   << std::endl;
 
+        auto instrument_ids = book_manager->get_all_instrument_ids();
+
+        if (replay) {
+            replay->add_listener(reuters_shared);
+            std::cout << "Replaying " << replay->size() << " records from " << options.replay_path << std::endl;
+        }
+
+        // Open-loop load mode paces the generator itself
+        std::unique_ptr<market_core::LoadGenerator> load;
+        if (options.load_mode && !replay) {
+            load = std::make_unique<market_core::LoadGenerator>(
+                *data_generator, instrument_ids, options.load_profile);
+            std::cout << "Load mode: " << market_core::LoadGenerator::shape_name(options.load_profile.shape)
+                      << " at " << options.load_profile.mean_rate() << " updates/s" << std::endl;
+        }
+
+        // Scenario groups are the multicast channels
+        std::unique_ptr<market_core::ScenarioRunner> scenario;
+        if (!options.scenario.empty() && !replay) {
+            market_core::ScenarioRunner::Groups groups;
+            for (const auto& channel : multicast_config.channel_feeds_a) {
+                groups["channel " + std::to_string(channel.channel_id)] = channel.instrument_ids;
+            }
+            scenario = std::make_unique<market_core::ScenarioRunner>(
+                *data_generator, options.scenario, std::move(groups), load.get());
+            std::string error;
+            if (!scenario->validate(error)) {
+                std::cerr << "Bad scenario: " << error << std::endl;
+                return 1;
+            }
+            std::cout << "Scenario: " << options.scenario.size() << " phases" << std::endl;
+            scenario->start();
+        }
+
         // Main server loop
+        auto start_time = std::chrono::steady_clock::now();
         auto last_market_update = std::chrono::steady_clock::now();
         auto last_stats_print = std::chrono::steady_clock::now();
         auto last_snapshot = std::chrono::steady_clock::now();
+        std::default_random_engine pick_engine(
+            std::chrono::high_resolution_clock::now().time_since_epoch().count());
 
         while (running) {
             auto now = std::chrono::steady_clock::now();
@@ -240,18 +396,34 @@ int main(int argc, char* argv[])
             // Process Reuters protocol (TCP connections, sessions)
             reuters_shared->run_once();
 
-            // Generate market data updates (reduced frequency)
-            if (std::chrono::duration_cast<std::chrono::milliseconds>(now - last_market_update).count() >= multicast_config.incremental_interval_ms) {
-                // Generate updates for only 1-2 instruments at a time instead of all 7
-                auto instrument_ids = book_manager->get_all_instrument_ids();
-                if (!instrument_ids.empty()) {
-                    // Pick 2 random instruments per update cycle
-                    auto time_seed = std::chrono::high_resolution_clock::now().time_since_epoch().count();
-                    std::default_random_engine generator(time_seed);
-                    std::shuffle(instrument_ids.begin(), instrument_ids.end(), generator);
+            if (scenario && !scenario->update()) {
+                std::cout << "Scenario complete" << std::endl;
+                running = false;
+            }
 
-                    for (size_t i = 0; i < std::min(size_t(2), instrument_ids.size()); ++i) {
-                        data_generator->generate_update(instrument_ids[i]);
+            if (replay) {
+                // Replay for 1ms, then come back for housekeeping
+                replay->run_for_ns(1000000);
+                if (replay->finished()) {
+                    std::cout << "Replay complete" << std::endl;
+                    running = false;
+                }
+            } else if (load) {
+                // Generate for 1ms, then come back for housekeeping
+                load->run_for_ns(1000000);
+            } else if (std::chrono::duration_cast<std::chrono::milliseconds>(now - last_market_update).count() >= multicast_config.incremental_interval_ms) {
+                // Generate updates for only 1-2 instruments at a time
+                if (!instrument_ids.empty()) {
+                    // Pick 2 distinct random instruments per update cycle
+                    std::uniform_int_distribution<size_t> pick(0, instrument_ids.size() - 1);
+                    size_t first = pick(pick_engine);
+                    data_generator->generate_update(instrument_ids[first]);
+                    if (instrument_ids.size() > 1) {
+                        size_t second = pick(pick_engine);
+                        while (second == first) {
+                            second = pick(pick_engine);
+                        }
+                        data_generator->generate_update(instrument_ids[second]);
                     }
                 }
                 last_market_update = now;
@@ -260,35 +432,10 @@ int main(int argc, char* argv[])
             // Generate snapshots periodically
             if (std::chrono::duration_cast<std::chrono::seconds>(now - last_snapshot).count() >= multicast_config.snapshot_interval_seconds) {
                 // Trigger snapshot generation for all instruments
-                for (auto id : book_manager->get_all_instrument_ids()) {
+                for (auto id : instrument_ids) {
                     auto book = book_manager->get_order_book(id);
                     if (book) {
-                        auto snapshot = std::make_shared<market_core::SnapshotEvent>(id);
-                        // Fill snapshot from book
-                        const auto& bids = book->get_bids(10);
-                        const auto& asks = book->get_asks(10);
-
-                        for (const auto& level : bids) {
-                            market_core::QuoteEvent quote(id);
-                            quote.side = market_core::Side::BID;
-                            quote.price = level.price;
-                            quote.quantity = level.quantity;
-                            quote.order_count = level.order_count;
-                            quote.action = market_core::UpdateAction::ADD;
-                            snapshot->bid_levels.push_back(quote);
-                        }
-
-                        for (const auto& level : asks) {
-                            market_core::QuoteEvent quote(id);
-                            quote.side = market_core::Side::ASK;
-                            quote.price = level.price;
-                            quote.quantity = level.quantity;
-                            quote.order_count = level.order_count;
-                            quote.action = market_core::UpdateAction::ADD;
-                            snapshot->ask_levels.push_back(quote);
-                        }
-
-                        reuters_shared->on_market_event(snapshot);
+                        reuters_shared->publish_book_snapshot(*book, multicast_config.book_depth);
                     }
                 }
                 last_snapshot = now;
@@ -305,16 +452,30 @@ int main(int argc, char* argv[])
                           << ", Recv=" << stats.messages_received
                           << ", Events=" << stats.market_events_processed
                           << std::endl;
+                if (load) {
+                    print_load_report(*load);
+                }
+                if (replay) {
+                    print_replay_report(*replay);
+                }
 
                 last_stats_print = now;
             }
 
-            // Small sleep to prevent busy waiting
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            if (options.duration_seconds > 0
+                && std::chrono::duration<double>(now - start_time).count() >= options.duration_seconds) {
+                running = false;
+            }
+
+            // Small sleep to prevent busy waiting; load and replay spin instead
+            if (!load && !replay) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
         }
 
         std::cout << "\nShutting down Reuters multicast server..." << std::endl;
         reuters_shared->shutdown();
+        data_generator->clear_listeners(); // The generator owns its listeners; release them here
 
         // Print final statistics
         const auto& final_stats = reuters_shared->get_statistics();
@@ -328,6 +489,28 @@ int main(int argc, char* argv[])
         std::cout << "  Messages sent: " << final_stats.messages_sent << std::endl;
         std::cout << "  Messages received: " << final_stats.messages_received << std::endl;
         std::cout << "  Market events processed: " << final_stats.market_events_processed << std::endl;
+        auto publisher_stats = reuters_shared->get_publisher_statistics();
+        std::cout << "  Snapshots: " << publisher_stats.snapshots_sent << " in "
+                  << publisher_stats.snapshot_packets << " packets" << std::endl;
+        std::cout << "  Incremental packets: " << publisher_stats.packets_sent
+                  << " (" << publisher_stats.messages_per_packet() << " messages, "
+                  << static_cast<uint64_t>(publisher_stats.bytes_per_packet()) << " bytes per packet; "
+                  << publisher_stats.entries_sent << " updates in " << publisher_stats.messages_sent_a << " messages)"
+                  << std::endl;
+        if (load) {
+            print_load_report(*load);
+        }
+        if (replay) {
+            print_replay_report(*replay);
+        }
+        if (scenario) {
+            scenario->stop();
+            print_scenario_report(*scenario);
+        }
+        if (recorder) {
+            recorder->close();
+            std::cout << "  Recorded " << recorder->records_written() << " events to " << options.record_path << std::endl;
+        }
 
         std::cout << "Reuters multicast server shutdown complete." << std::endl;
 
@@ -33,7 +33,7 @@ bool UDPTransport::create_multicast_sender(const std::string& multicast_ip,
     // Create UDP socket
     socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
     if (socket_fd_ < 0) {
-        last_error_ = "Failed to create socket: " + std::string(strerror(errno));
+        set_error("Failed to create socket: " + std::string(strerror(errno)));
         return false;
     }
 
@@ -42,7 +42,7 @@ bool UDPTransport::create_multicast_sender(const std::string& multicast_ip,
     send_addr_.sin_family = AF_INET;
     send_addr_.sin_port = htons(port);
     if (inet_pton(AF_INET, multicast_ip.c_str(), &send_addr_.sin_addr) <= 0) {
-        last_error_ = "Invalid multicast address: " + multicast_ip;
+        set_error("Invalid multicast address: " + multicast_ip);
         close();
         return false;
     }
@@ -73,14 +73,14 @@ bool UDPTransport::create_multicast_receiver(const std::string& multicast_ip,
     // Create UDP socket
     socket_fd_ = socket(AF_INET, SOCK_DGRAM, 0);
     if (socket_fd_ < 0) {
-        last_error_ = "Failed to create socket: " + std::string(strerror(errno));
+        set_error("Failed to create socket: " + std::string(strerror(errno)));
         return false;
     }
 
     // Allow multiple sockets to use the same port
     int reuse = 1;
     if (setsockopt(socket_fd_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse)) < 0) {
-        last_error_ = "Failed to set SO_REUSEADDR: " + std::string(strerror(errno));
+        set_error("Failed to set SO_REUSEADDR: " + std::string(strerror(errno)));
         close();
         return false;
     }
@@ -93,7 +93,7 @@ bool UDPTransport::create_multicast_receiver(const std::string& multicast_ip,
     bind_addr.sin_addr.s_addr = INADDR_ANY;
 
     if (bind(socket_fd_, (struct sockaddr*)&bind_addr, sizeof(bind_addr)) < 0) {
-        last_error_ = "Failed to bind to port " + std::to_string(port) + ": " + std::string(strerror(errno));
+        set_error("Failed to bind to port " + std::to_string(port) + ": " + std::string(strerror(errno)));
         close();
         return false;
     }
@@ -115,7 +115,7 @@ bool UDPTransport::send(const std::vector<uint8_t>& data)
 bool UDPTransport::send(const uint8_t* data, size_t length)
 {
     if (socket_fd_ < 0 || !is_sender_) {
-        last_error_ = "Socket not configured for sending";
+        send_failure_ = SendFailure::NOT_SENDER;
         return false;
     }
 
@@ -123,18 +123,37 @@ bool UDPTransport::send(const uint8_t* data, size_t length)
         (struct sockaddr*)&send_addr_, sizeof(send_addr_));
 
     if (sent < 0) {
-        last_error_ = "Send failed: " + std::string(strerror(errno));
+        send_failure_ = SendFailure::SEND_FAILED;
+        send_errno_ = errno;
         return false;
     }
 
     if (static_cast<size_t>(sent) != length) {
-        last_error_ = "Partial send: " + std::to_string(sent) + " of " + std::to_string(length);
+        send_failure_ = SendFailure::PARTIAL;
+        send_sent_ = static_cast<size_t>(sent);
+        send_length_ = length;
         return false;
     }
 
+    send_failure_ = SendFailure::NONE;
     return true;
 }
 
+std::string UDPTransport::get_last_error() const
+{
+    switch (send_failure_) {
+    case SendFailure::NOT_SENDER:
+        return "Socket not configured for sending";
+    case SendFailure::SEND_FAILED:
+        return "Send failed: " + std::string(strerror(send_errno_));
+    case SendFailure::PARTIAL:
+        return "Partial send: " + std::to_string(send_sent_) + " of " + std::to_string(send_length_);
+    case SendFailure::NONE:
+        break;
+    }
+    return last_error_;
+}
+
 std::vector<uint8_t> UDPTransport::receive(size_t max_size)
 {
     if (socket_fd_ < 0 || is_sender_) {
@@ -150,7 +169,7 @@ std::vector<uint8_t> UDPTransport::receive(size_t max_size)
 
     if (received < 0) {
         if (errno != EAGAIN && errno != EWOULDBLOCK) {
-            last_error_ = "Receive failed: " + std::string(strerror(errno));
+            set_error("Receive failed: " + std::string(strerror(errno)));
         }
         return {};
     }
@@ -219,7 +238,7 @@ bool UDPTransport::join_multicast_group()
     }
 
     if (setsockopt(socket_fd_, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
-        last_error_ = "Failed to join multicast group: " + std::string(strerror(errno));
+        set_error("Failed to join multicast group: " + std::string(strerror(errno)));
         return false;
     }
 
@@ -230,12 +249,12 @@ bool UDPTransport::set_multicast_interface()
 {
     struct in_addr iface_addr;
     if (inet_pton(AF_INET, interface_ip_.c_str(), &iface_addr) <= 0) {
-        last_error_ = "Invalid interface IP: " + interface_ip_;
+        set_error("Invalid interface IP: " + interface_ip_);
         return false;
     }
 
     if (setsockopt(socket_fd_, IPPROTO_IP, IP_MULTICAST_IF, &iface_addr, sizeof(iface_addr)) < 0) {
-        last_error_ = "Failed to set multicast interface: " + std::string(strerror(errno));
+        set_error("Failed to set multicast interface: " + std::string(strerror(errno)));
         return false;
     }
 
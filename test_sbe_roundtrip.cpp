@@ -1,18 +1,57 @@
 #include "core/include/instrument.h"
 #include "core/include/market_events.h"
+#include "core/include/order_book.h"
 #include "include/reuters_encoder.h"
+#include "include/reuters_multicast_publisher.h"
 #include "include/utp_sbe/utp_sbe/MDFullRefresh.h"
+#include "include/utp_sbe/utp_sbe/MDIncrementalRefresh.h"
 #include "include/utp_sbe/utp_sbe/MessageHeader.h"
 #include "include/utp_sbe/utp_sbe/SecurityDefinition.h"
+#include <atomic>
 #include <cassert>
+#include <cstdlib>
 #include <cstring>
 #include <iostream>
+#include <new>
+#include <thread>
 
 /**
  * Test that verifies SBE encoding/decoding roundtrip works correctly
  * This ensures that what the server encodes, the client can decode
  */
 
+static int failures = 0;
+
+static void check(bool condition, const std::string& what)
+{
+    if (!condition) {
+        std::cerr << "❌ " << what << std::endl;
+        ++failures;
+    }
+}
+
+// Count heap allocations so the publish path can be checked for zero
+static std::atomic<size_t> allocations { 0 };
+
+__attribute__((noinline)) void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+__attribute__((noinline)) void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+__attribute__((noinline)) void operator delete(void* p, size_t) noexcept
+{
+    std::free(p);
+}
+
 void test_security_definition_roundtrip()
 {
     std::cout << "\n=== Testing SecurityDefinition SBE Roundtrip ===" << std::endl;
@@ -170,6 +209,527 @@ void test_market_data_roundtrip()
     std::cout << "  ✓ SBE message structure is correct" << std::endl;
 }
 
+void test_encode_into_buffer()
+{
+    std::cout << "\n=== Testing encode into caller buffer ===" << std::endl;
+    using reuters_protocol::ReutersEncoder;
+
+    market_core::MarketEventRecord quote;
+    quote.type = market_core::MarketEvent::QUOTE_UPDATE;
+    quote.instrument_id = 1001;
+    quote.sequence_number = 77;
+    quote.timestamp_ns = 123456789;
+    quote.quote.side = market_core::Side::BID;
+    quote.quote.price = 1.0851;
+    quote.quote.quantity = 1000000;
+    quote.quote.action = market_core::UpdateAction::ADD;
+
+    market_core::MarketEventRecord trade = quote;
+    trade.type = market_core::MarketEvent::TRADE;
+    trade.trade.price = 1.0852;
+    trade.trade.quantity = 500000;
+    trade.trade.aggressor_side = market_core::Side::ASK;
+
+    // The buffer form writes the same bytes as the vector form, at any offset
+    uint8_t buffer[256];
+    const size_t offset = 20;
+    for (const auto* record : { &quote, &trade }) {
+        std::vector<uint8_t> expected = ReutersEncoder::encode_market_data_incremental(*record);
+        memset(buffer, 0xAB, sizeof(buffer));
+        size_t length = ReutersEncoder::encode_market_data_incremental(*record, buffer, offset, sizeof(buffer));
+        check(length == expected.size() && length > 0, "buffer encode length matches vector encode");
+        check(length == expected.size() && memcmp(buffer + offset, expected.data(), length) == 0,
+            "buffer encode bytes match vector encode");
+        check(buffer[offset - 1] == 0xAB, "encode leaves bytes before the offset alone");
+
+        // Too small for the message: nothing is written
+        check(ReutersEncoder::encode_market_data_incremental(*record, buffer, offset, offset + length - 1) == 0,
+            "encode refuses a buffer one byte short");
+    }
+
+    // Decode the quote in place: prices are rounded, not truncated, to 1e-9
+    size_t length = ReutersEncoder::encode_market_data_incremental(quote, buffer, offset, sizeof(buffer));
+    utp_sbe::MessageHeader header(reinterpret_cast<char*>(buffer), offset, sizeof(buffer), 0);
+    check(header.templateId() == utp_sbe::MDIncrementalRefresh::SBE_TEMPLATE_ID, "quote encodes as MDIncrementalRefresh");
+    utp_sbe::MDIncrementalRefresh refresh;
+    refresh.wrapForDecode(reinterpret_cast<char*>(buffer), offset + header.encodedLength(),
+        header.blockLength(), header.version(), offset + length);
+    check(refresh.securityID() == 1001 && refresh.rptSeq() == 77, "quote header fields round trip");
+    auto& entries = refresh.noMDEntries();
+    check(entries.count() == 1, "quote has one entry");
+    if (entries.hasNext()) {
+        auto& entry = entries.next();
+        check(entry.mDEntryPx().mantissa() == 1085100000, "1.0851 encodes as mantissa 1085100000");
+        check(entry.mDEntrySize() == 1000000, "quote size round trips");
+    }
+
+    // Non-incremental records encode nothing
+    market_core::MarketEventRecord status = quote;
+    status.type = market_core::MarketEvent::STATUS_CHANGE;
+    check(ReutersEncoder::encode_market_data_incremental(status, buffer, 0, sizeof(buffer)) == 0,
+        "status records are not incremental");
+
+    // Snapshots and heartbeats follow the same contract
+    market_core::SnapshotEvent snapshot(1001);
+    for (int i = 0; i < 5; ++i) {
+        market_core::QuoteEvent level(1001);
+        level.quantity = 1000000;
+        level.price = 1.0850 - i * 0.0001;
+        snapshot.bid_levels.push_back(level);
+        level.price = 1.0851 + i * 0.0001;
+        snapshot.ask_levels.push_back(level);
+    }
+    std::vector<uint8_t> expected = ReutersEncoder::encode_market_data_snapshot(snapshot);
+    length = ReutersEncoder::encode_market_data_snapshot(snapshot, buffer, offset, sizeof(buffer));
+    check(length == expected.size() && memcmp(buffer + offset, expected.data(), length) == 0,
+        "snapshot buffer encode matches vector encode");
+    check(ReutersEncoder::encode_market_data_snapshot(snapshot, buffer, offset, offset + length - 1) == 0,
+        "snapshot encode refuses a short buffer");
+    expected = ReutersEncoder::encode_heartbeat();
+    length = ReutersEncoder::encode_heartbeat(buffer, offset, sizeof(buffer));
+    check(length == expected.size() && memcmp(buffer + offset, expected.data(), length) == 0,
+        "heartbeat buffer encode matches vector encode");
+
+    std::cout << "Encode-into-buffer checks done" << std::endl;
+}
+
+// Global feeds plus channel 1, which carries instrument 1001
+static reuters_protocol::ReutersMulticastConfig publisher_config()
+{
+    auto feed = [](const std::string& ip, uint16_t port, int channel_id) {
+        reuters_protocol::MulticastChannelConfig channel;
+        channel.multicast_ip = ip;
+        channel.port = port;
+        channel.interface_ip = "0.0.0.0";
+        channel.channel_id = channel_id;
+        return channel;
+    };
+    reuters_protocol::ReutersMulticastConfig config;
+    config.incremental_feed_a = feed("239.100.1.1", 31001, 0);
+    config.incremental_feed_b = feed("239.100.1.2", 31002, 0);
+    config.security_definition_feed = feed("239.100.1.3", 31003, 0);
+    config.snapshot_feed = feed("239.100.1.4", 31004, 0);
+    config.channel_feeds_a.push_back(feed("239.100.2.1", 31101, 1));
+    config.channel_feeds_a.back().instrument_ids = { 1001 };
+    config.channel_feeds_b.push_back(feed("239.100.2.2", 31102, 1));
+    return config;
+}
+
+static market_core::MarketEventRecord quote_record(uint32_t instrument_id, uint64_t sequence, double price)
+{
+    market_core::MarketEventRecord record = market_core::MarketEventRecord::make_quote(instrument_id);
+    record.sequence_number = sequence;
+    record.timestamp_ns = 1000 + sequence;
+    record.quote.side = (sequence % 2 == 0) ? market_core::Side::BID : market_core::Side::ASK;
+    record.quote.action = market_core::UpdateAction::CHANGE;
+    record.quote.price = price;
+    record.quote.quantity = 1000000 + sequence;
+    return record;
+}
+
+static market_core::MarketEventRecord trade_record(uint32_t instrument_id, uint64_t sequence, double price)
+{
+    market_core::MarketEventRecord record = market_core::MarketEventRecord::make_trade(instrument_id);
+    record.sequence_number = sequence;
+    record.timestamp_ns = 1000 + sequence;
+    record.trade.price = price;
+    record.trade.quantity = 500000;
+    record.trade.aggressor_side = market_core::Side::BID;
+    return record;
+}
+
+void test_incremental_batching()
+{
+    std::cout << "\n=== Testing multi-entry incrementals ===" << std::endl;
+    using reuters_protocol::ReutersEncoder;
+
+    // Five level changes on one instrument encode as one message
+    std::vector<market_core::MarketEventRecord> quotes;
+    for (uint64_t i = 0; i < 5; ++i) {
+        quotes.push_back(quote_record(1001, 40 + i, 1.0850 + i * 0.00001));
+    }
+    std::vector<const market_core::MarketEventRecord*> refs;
+    for (const auto& quote : quotes) {
+        refs.push_back(&quote);
+    }
+    uint8_t buffer[1024];
+    size_t length = ReutersEncoder::encode_market_data_incremental(refs.data(), refs.size(), buffer, 0, sizeof(buffer));
+    size_t single = ReutersEncoder::encode_market_data_incremental(quotes[0], buffer + 512, 0, 512);
+    check(length > 0 && length < 5 * single, "five quotes share one message");
+
+    utp_sbe::MessageHeader header(reinterpret_cast<char*>(buffer), 0, sizeof(buffer), 0);
+    utp_sbe::MDIncrementalRefresh refresh;
+    refresh.wrapForDecode(reinterpret_cast<char*>(buffer), header.encodedLength(),
+        header.blockLength(), header.version(), length);
+    check(refresh.securityID() == 1001, "batched message keeps the SecurityID");
+    check(refresh.rptSeq() == 40, "batched message carries the first rptSeq");
+    check(refresh.transactTime() == quotes.back().timestamp_ns, "batched message is stamped with the last update");
+    auto& entries = refresh.noMDEntries();
+    check(entries.count() == 5, "one entry per quote");
+    for (uint64_t i = 0; entries.hasNext(); ++i) {
+        auto& entry = entries.next();
+        check(entry.mDEntrySize() == static_cast<int64_t>(1000040 + i), "entries keep their order");
+    }
+
+    // One message is one instrument and one type
+    market_core::MarketEventRecord other = quote_record(1002, 45, 1.2650);
+    market_core::MarketEventRecord trade = trade_record(1001, 45, 1.0851);
+    refs.push_back(&other);
+    check(ReutersEncoder::encode_market_data_incremental(refs.data(), refs.size(), buffer, 0, sizeof(buffer)) == 0,
+        "mixed instruments are refused");
+    refs.back() = &trade;
+    check(ReutersEncoder::encode_market_data_incremental(refs.data(), refs.size(), buffer, 0, sizeof(buffer)) == 0,
+        "mixed quotes and trades are refused");
+
+    reuters_protocol::ReutersMulticastConfig config = publisher_config();
+    config.batch_window_us = 10000000; // Only explicit flushes
+    reuters_protocol::ReutersMulticastPublisher publisher(config);
+    if (!publisher.initialize()) {
+        std::cout << "⚠️  Multicast sockets unavailable, skipping" << std::endl;
+        return;
+    }
+    const auto& stats = publisher.get_statistics();
+
+    // Quote run on 1001, trades on 2002 in between, then a trade that
+    // interrupts the 1001 run and two quotes after it
+    for (int round = 0; round < 2; ++round) {
+        size_t before = allocations.load();
+        uint64_t messages = stats.messages_sent_a;
+        uint64_t entries = stats.entries_sent;
+        uint64_t base = 100 + round * 10;
+        for (uint64_t i = 0; i < 5; ++i) {
+            publisher.publish_incremental(quote_record(1001, base + i, 1.0850));
+            if (i % 2 == 0) {
+                publisher.publish_incremental(trade_record(2002, base + i, 1.2650));
+            }
+        }
+        publisher.publish_incremental(trade_record(1001, base + 5, 1.0850));
+        publisher.publish_incremental(quote_record(1001, base + 6, 1.0850));
+        publisher.publish_incremental(quote_record(1001, base + 8, 1.0850)); // Gap: own message
+        uint64_t queued = stats.messages_sent_a - messages;
+        publisher.flush_incremental(true);
+        uint64_t early = stats.messages_sent_a - messages;
+        publisher.flush_incremental();
+        size_t allocated = allocations.load() - before;
+
+        check(queued == 0, "nothing is sent inside the batch window");
+        check(early == 0, "an open window is not flushed early");
+        check(stats.messages_sent_a - messages == 5, "quote run, trades, trade, quote, gapped quote: five messages");
+        check(stats.entries_sent - entries == 11, "every update is an entry");
+        if (round == 1) {
+            check(allocated == 0, "batching does not allocate once warm");
+        }
+    }
+
+    // A generator batch is grouped the same way
+    std::vector<market_core::MarketEventRecord> block;
+    for (uint64_t i = 0; i < 4; ++i) {
+        block.push_back(quote_record(1001, 200 + i, 1.0850));
+        block.push_back(quote_record(2002, 200 + i, 1.2650));
+    }
+    config.batch_window_us = 0;
+    reuters_protocol::ReutersMulticastPublisher unbatched(config);
+    if (unbatched.initialize()) {
+        unbatched.publish_incremental(block.data(), block.size());
+        check(unbatched.get_statistics().messages_sent_a == 2, "a block of two instruments is two messages");
+        check(unbatched.get_statistics().entries_sent == 8, "a block keeps all its updates");
+    }
+
+    // Only a channel with a B feed counts B messages
+    config.channel_feeds_b.clear();
+    reuters_protocol::ReutersMulticastPublisher single_feed(config);
+    if (single_feed.initialize()) {
+        single_feed.publish_incremental(quote_record(1001, 300, 1.0850));
+        single_feed.publish_incremental(quote_record(2002, 300, 1.2650));
+        check(single_feed.get_statistics().messages_sent_a == 2 && single_feed.get_statistics().messages_sent_b == 1,
+            "a channel without a B feed sends no B messages");
+    }
+}
+
+void test_packet_packing()
+{
+    std::cout << "\n=== Testing packet packing ===" << std::endl;
+
+    // Room for two incrementals after the packet header, not three
+    size_t message = reuters_protocol::ReutersEncoder::encode_market_data_incremental(quote_record(2002, 0, 1.2650)).size();
+    reuters_protocol::ReutersMulticastConfig config = publisher_config();
+    config.packet_mtu = static_cast<uint32_t>(reuters_protocol::ReutersMulticastPublisher::PACKET_HEADER_SIZE + 2 * message + message / 2);
+    config.packet_max_latency_us = 1000;
+    reuters_protocol::ReutersMulticastPublisher publisher(config);
+    if (!publisher.initialize()) {
+        std::cout << "⚠️  Multicast sockets unavailable, skipping" << std::endl;
+        return;
+    }
+    const auto& stats = publisher.get_statistics();
+
+    size_t before = allocations.load();
+    for (uint64_t i = 0; i < 9; ++i) {
+        publisher.publish_incremental(quote_record(2002, i, 1.2650));
+    }
+    uint64_t full_packets = stats.packets_sent;
+    publisher.flush_incremental(true);
+    uint64_t after_early_flush = stats.packets_sent;
+    size_t allocated = allocations.load() - before;
+
+    check(full_packets == 4, "a packet is sent once the next message does not fit");
+    check(after_early_flush == 4, "a packet younger than the latency bound stays open");
+    check(allocated == 0, "packing does not allocate");
+
+    // The latency bound sends a packet that never fills
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    publisher.flush_incremental(true);
+    check(stats.packets_sent == 5, "the latency bound flushes the last packet");
+    check(stats.packet_messages == 9 && stats.messages_sent_a == 9, "every message is packed exactly once");
+    check(stats.messages_per_packet() == 9.0 / 5.0, "messages per packet are reported");
+    check(stats.bytes_per_packet() == (5 * 20.0 + 9.0 * message) / 5.0, "bytes per packet count the headers once");
+
+    // Each channel packs separately, and heartbeats close the packet
+    publisher.publish_incremental(quote_record(1001, 100, 1.0850));
+    publisher.publish_incremental(quote_record(2002, 100, 1.2650));
+    publisher.send_heartbeat();
+    check(stats.packets_sent == 7, "heartbeats flush every channel's packet");
+    check(stats.packet_messages == 13, "heartbeats ride in the packets they close");
+
+    // A run longer than one packet holds is split into messages that fit
+    std::vector<market_core::MarketEventRecord> burst;
+    for (uint64_t i = 0; i < 12; ++i) {
+        burst.push_back(quote_record(2002, 200 + i, 1.2650));
+    }
+    size_t per_message = reuters_protocol::ReutersEncoder::incremental_message_entries(
+        market_core::MarketEvent::QUOTE_UPDATE, config.packet_mtu - reuters_protocol::ReutersMulticastPublisher::PACKET_HEADER_SIZE);
+    size_t burst_messages = (burst.size() + per_message - 1) / per_message;
+    publisher.publish_incremental(burst.data(), burst.size());
+    publisher.flush_incremental();
+    check(per_message > 1 && burst_messages > 1, "the burst is larger than one packet");
+    check(stats.packet_messages == 13 + burst_messages && stats.entries_sent == 11 + burst.size(),
+        "an oversized batch is split into messages that fit the MTU");
+    check(stats.bytes_per_packet() <= config.packet_mtu, "no packet exceeds the MTU");
+}
+
+void test_security_definition_cycle()
+{
+    std::cout << "\n=== Testing security definition cache ===" << std::endl;
+
+    reuters_protocol::ReutersMulticastConfig config = publisher_config();
+    config.security_definition_interval_seconds = 1;
+    reuters_protocol::ReutersMulticastPublisher publisher(config);
+    if (!publisher.initialize()) {
+        std::cout << "⚠️  Multicast sockets unavailable, skipping" << std::endl;
+        return;
+    }
+    const auto& stats = publisher.get_statistics();
+
+    std::vector<market_core::Instrument> instruments;
+    for (uint32_t i = 0; i < 100; ++i) {
+        instruments.emplace_back(5000 + i, "SYM" + std::to_string(i), market_core::InstrumentType::FX_SPOT);
+    }
+    size_t added = 0;
+    for (const auto& instrument : instruments) {
+        added += publisher.update_security_definition(instrument) ? 1 : 0;
+    }
+    check(added == 100 && publisher.security_definition_count() == 100, "every new instrument is cached");
+
+    // Unchanged instruments are not re-encoded; a new symbol is
+    size_t changed = 0;
+    for (const auto& instrument : instruments) {
+        changed += publisher.update_security_definition(instrument) ? 1 : 0;
+    }
+    check(changed == 0, "unchanged instruments keep their cached definition");
+    instruments[7].primary_symbol = "RENAMED";
+    check(publisher.update_security_definition(instruments[7]), "a changed symbol re-encodes the definition");
+    check(publisher.security_definition_count() == 100, "a changed instrument replaces its entry");
+
+    // The cycle is spread over the interval, not sent in one burst
+    auto start = std::chrono::steady_clock::now();
+    size_t before = allocations.load();
+    size_t at_start = publisher.rebroadcast_security_definitions(start);
+    size_t quarter = publisher.rebroadcast_security_definitions(start + std::chrono::milliseconds(250));
+    size_t rest = publisher.rebroadcast_security_definitions(start + std::chrono::milliseconds(1000));
+    size_t next_half = publisher.rebroadcast_security_definitions(start + std::chrono::milliseconds(1500));
+    size_t late = publisher.rebroadcast_security_definitions(start + std::chrono::milliseconds(5000));
+    size_t allocated = allocations.load() - before;
+
+    check(at_start == 0, "nothing is due at the start of a cycle");
+    check(quarter == 25, "a quarter of the cycle is due after a quarter of the interval");
+    check(rest == 75, "the cycle completes at the end of the interval");
+    check(next_half == 50, "the next cycle starts on schedule");
+    check(late == 50, "a late caller finishes the cycle and restarts from now");
+    check(stats.definitions_sent == 200, "every rebroadcast definition is sent");
+    check(allocated == 0, "rebroadcasting does not allocate");
+
+    // Definitions and snapshots number their own feeds, not the incrementals'
+    uint64_t sequence = publisher.get_next_sequence_number(0);
+    publisher.rebroadcast_security_definitions(start + std::chrono::milliseconds(6000));
+    publisher.publish_snapshot(market_core::OrderBook(5000, "SYM0"), SIZE_MAX);
+    check(publisher.get_next_sequence_number(0) == sequence + 1, "control feeds leave incremental sequence gaps");
+}
+
+void test_snapshot_fragments()
+{
+    std::cout << "\n=== Testing snapshot fragmentation ===" << std::endl;
+
+    // 1000 levels a side: far more than one datagram holds
+    std::vector<market_core::PriceLevel> bids(1000);
+    std::vector<market_core::PriceLevel> asks(1000);
+    for (size_t i = 0; i < bids.size(); ++i) {
+        bids[i].price = 1.0850 - i * 0.00001;
+        bids[i].quantity = 1000000 + i;
+        asks[i].price = 1.0851 + i * 0.00001;
+        asks[i].quantity = 2000000 + i;
+    }
+    reuters_protocol::SnapshotBookView view;
+    view.instrument_id = 1001;
+    view.rpt_seq = 77;
+    view.transact_time = 123456789;
+    view.last_msg_seq_num_processed = 4242;
+    view.bids = bids.data();
+    view.bid_count = bids.size();
+    view.asks = asks.data();
+    view.ask_count = asks.size();
+
+    const size_t limit = reuters_protocol::ReutersMulticastPublisher::SNAPSHOT_PACKET_SIZE
+        - reuters_protocol::ReutersMulticastPublisher::PACKET_HEADER_SIZE;
+    size_t per_fragment = reuters_protocol::ReutersEncoder::snapshot_fragment_entries(limit);
+    size_t fragments = (view.entry_count() + per_fragment - 1) / per_fragment;
+    std::vector<uint8_t> buffer(fragments * limit);
+    std::vector<size_t> lengths(fragments);
+
+    size_t before = allocations.load();
+    for (size_t i = 0; i < fragments; ++i) {
+        size_t first = i * per_fragment;
+        size_t count = std::min(per_fragment, view.entry_count() - first);
+        lengths[i] = reuters_protocol::ReutersEncoder::encode_market_data_snapshot(
+            view, first, count, buffer.data(), i * limit, (i + 1) * limit);
+    }
+    size_t allocated = allocations.load() - before;
+
+    check(per_fragment > 0 && fragments > 1, "a deep book needs several fragments");
+    check(allocated == 0, "encoding fragments does not allocate");
+    check(reuters_protocol::ReutersEncoder::encode_market_data_snapshot(
+              view, 0, per_fragment + 1, buffer.data(), 0, limit) == 0,
+        "a fragment over the limit is refused");
+
+    // Decode every fragment and walk the book back out of them
+    size_t entry = 0;
+    bool metadata = true;
+    bool in_limit = true;
+    bool levels = true;
+    for (size_t i = 0; i < fragments; ++i) {
+        in_limit = in_limit && lengths[i] > 0 && lengths[i] <= limit;
+        char* bytes = reinterpret_cast<char*>(buffer.data() + i * limit);
+        utp_sbe::MessageHeader header(bytes, 0, limit, utp_sbe::MDFullRefresh::sbeSchemaVersion());
+        utp_sbe::MDFullRefresh decoded;
+        decoded.wrapForDecode(bytes, header.encodedLength(), header.blockLength(), header.version(), limit);
+        metadata = metadata && header.templateId() == utp_sbe::MDFullRefresh::SBE_TEMPLATE_ID
+            && decoded.securityID() == 1001 && decoded.rptSeq() == 77 && decoded.transactTime() == 123456789
+            && decoded.lastMsgSeqNumProcessed() == 4242 && decoded.marketDepth() == 255;
+        auto& group = decoded.noMDEntries();
+        while (group.hasNext()) {
+            group.next();
+            bool bid = entry < bids.size();
+            const market_core::PriceLevel& level = bid ? bids[entry] : asks[entry - bids.size()];
+            levels = levels && (group.mDEntryType() == (bid ? utp_sbe::MDEntryType::BID : utp_sbe::MDEntryType::OFFER))
+                && group.mDEntryPx().mantissa() == std::llround(level.price * 1e9)
+                && group.mDEntrySize() == static_cast<int64_t>(level.quantity);
+            ++entry;
+        }
+    }
+    check(in_limit, "every fragment fits one packet");
+    check(metadata, "every fragment carries the snapshot metadata");
+    check(levels && entry == view.entry_count(), "fragments carry every level once, bids then asks");
+
+    // The publisher splits a deep book the same way, straight from the book
+    reuters_protocol::ReutersMulticastPublisher publisher(publisher_config());
+    if (!publisher.initialize()) {
+        std::cout << "⚠️  Multicast sockets unavailable, skipping" << std::endl;
+        return;
+    }
+    const auto& stats = publisher.get_statistics();
+    market_core::OrderBook book(1001, "EURUSD");
+    for (size_t i = 0; i < 600; ++i) {
+        book.add_level(market_core::Side::BID, bids[i]);
+        book.add_level(market_core::Side::ASK, asks[i]);
+    }
+    size_t packets = publisher.publish_snapshot(book, SIZE_MAX);
+    before = allocations.load();
+    size_t again = publisher.publish_snapshot(book, SIZE_MAX);
+    allocated = allocations.load() - before;
+
+    check(packets == (1200 + per_fragment - 1) / per_fragment && again == packets, "one packet per fragment");
+    check(stats.snapshots_sent == 2 && stats.snapshot_packets == 2 * packets, "snapshot packets are counted");
+    check(allocated == 0, "a repeated book snapshot does not allocate");
+    check(publisher.publish_snapshot(market_core::OrderBook(1002, "GBPUSD"), SIZE_MAX) == 1,
+        "an empty book is one fragment");
+
+    // A book records the sequence it reflects, for the snapshot's rptSeq
+    market_core::MarketEventRecord update = quote_record(1001, 314, 1.0849);
+    book.apply_record(update);
+    check(book.get_last_sequence() == 314, "the book records the last applied sequence");
+
+    // Updates still waiting in a batch are sent before the snapshot
+    reuters_protocol::ReutersMulticastConfig batched_config = publisher_config();
+    batched_config.batch_window_us = 1000000;
+    reuters_protocol::ReutersMulticastPublisher batched(batched_config);
+    if (!batched.initialize()) {
+        return;
+    }
+    batched.publish_incremental(update);
+    uint64_t held = batched.get_statistics().messages_sent_a;
+    batched.publish_snapshot(book, SIZE_MAX);
+    check(held == 0 && batched.get_statistics().messages_sent_a == 1,
+        "a snapshot flushes its channel's pending updates first");
+}
+
+void test_publisher_zero_allocation()
+{
+    std::cout << "\n=== Testing publisher allocations ===" << std::endl;
+
+    reuters_protocol::ReutersMulticastPublisher publisher(publisher_config());
+    if (!publisher.initialize()) {
+        std::cout << "⚠️  Multicast sockets unavailable, skipping" << std::endl;
+        return;
+    }
+    check(publisher.get_channel_for_instrument(1001) == 1, "instrument 1001 routes to channel 1");
+    check(publisher.get_channel_for_instrument(2002) == 0, "unmapped instruments route to the global feeds");
+
+    market_core::MarketEventRecord quote;
+    quote.type = market_core::MarketEvent::QUOTE_UPDATE;
+    quote.instrument_id = 1001;
+    quote.quote.side = market_core::Side::BID;
+    quote.quote.price = 1.0850;
+    quote.quote.quantity = 1000000;
+    quote.quote.action = market_core::UpdateAction::CHANGE;
+    market_core::MarketEventRecord trade = quote;
+    trade.type = market_core::MarketEvent::TRADE;
+    trade.instrument_id = 2002;
+    trade.trade.price = 1.0851;
+    trade.trade.quantity = 250000;
+
+    const int rounds = 1000;
+    size_t before = allocations.load();
+    for (int i = 0; i < rounds; ++i) {
+        quote.sequence_number = static_cast<uint64_t>(i);
+        quote.quote.price = 1.0850 + (i % 10) * 0.00001;
+        publisher.publish_incremental(quote);
+        publisher.publish_incremental(trade);
+    }
+    publisher.send_heartbeat();
+    size_t allocated = allocations.load() - before;
+    std::cout << "Heap allocations over " << 2 * rounds << " published events: " << allocated << std::endl;
+    check(allocated == 0, "publishing incrementals does not allocate");
+
+    const auto& stats = publisher.get_statistics();
+    check(stats.messages_sent_a == 2 * rounds, "every incremental is published");
+
+    // Disabled channels fall back to the global feeds
+    publisher.enable_channel(1, false);
+    publisher.publish_incremental(quote);
+    check(stats.messages_sent_a == 2 * rounds + 1, "disabled channel still publishes on the global feeds");
+    publisher.shutdown();
+    publisher.publish_incremental(quote);
+    check(stats.messages_sent_a == 2 * rounds + 1, "nothing is published after shutdown");
+}
+
 int main()
 {
     std::cout << "Reuters SBE Roundtrip Test" << std::endl;
@@ -180,6 +740,17 @@ int main()
     try {
         test_security_definition_roundtrip();
         test_market_data_roundtrip();
+        test_encode_into_buffer();
+        test_publisher_zero_allocation();
+        test_incremental_batching();
+        test_packet_packing();
+        test_security_definition_cycle();
+        test_snapshot_fragments();
+
+        if (failures > 0) {
+            std::cout << "\n❌ " << failures << " ROUNDTRIP CHECKS FAILED" << std::endl;
+            return 1;
+        }
 
         std::cout << "\n🎉 ALL ROUNDTRIP TESTS COMPLETED!" << std::endl;
         std::cout << "The SBE implementation correctly encodes and decodes messages" << std::endl;
@@ -163,6 +163,16 @@ void UTPClient::parse_message(const uint8_t* buffer, size_t size)
     std::cout << "Message size: " << size << " bytes\n";
     hex_dump(buffer, std::min(size, size_t(48)));
 
+    // A TR Binary Packet Header announces its length; the messages follow
+    // it back to back
+    if (size >= TR_HEADER_SIZE + 8 && buffer[16] == TR_HEADER_SIZE && buffer[17] == 1) {
+        uint16_t packet_len = le16toh(*reinterpret_cast<const uint16_t*>(buffer + 18));
+        if (packet_len > TR_HEADER_SIZE && packet_len <= size) {
+            parse_tr_packet(buffer, packet_len);
+            return;
+        }
+    }
+
     // Check if this looks like a multicast header or direct SBE
     // Look for SBE header pattern in first 32 bytes
     size_t sbe_offset = 0;
@@ -200,6 +210,29 @@ void UTPClient::parse_message(const uint8_t* buffer, size_t size)
     }
 }
 
+size_t UTPClient::parse_tr_packet(const uint8_t* buffer, size_t size)
+{
+    parse_tr_packet_header(buffer);
+
+    size_t offset = TR_HEADER_SIZE;
+    size_t messages = 0;
+    while (offset + utp_sbe::MessageHeader::encodedLength() <= size) {
+        std::cout << "\n=== SBE Message " << messages + 1 << " (offset " << offset << ") ===\n";
+        size_t length = parse_sbe_message_at_offset(buffer, size, offset);
+        if (length == 0) {
+            break; // Unknown or damaged: the rest of the packet cannot be framed
+        }
+        offset += length;
+        ++messages;
+    }
+
+    std::cout << "Messages in packet: " << messages << std::endl;
+    if (offset != size) {
+        std::cout << "Unparsed bytes at end of packet: " << size - offset << std::endl;
+    }
+    return messages;
+}
+
 void UTPClient::parse_tr_packet_header(const uint8_t* buffer)
 {
     std::cout << "\n--- Thomson Reuters Binary Packet Header ---\n";
@@ -275,32 +308,27 @@ void UTPClient::parse_sbe_message(const uint8_t* buffer, size_t size)
     }
 }
 
-void UTPClient::parse_sbe_message_at_offset(const uint8_t* buffer, size_t size, size_t offset)
+size_t UTPClient::parse_sbe_message_at_offset(const uint8_t* buffer, size_t size, size_t offset)
 {
     try {
         utp_sbe::MessageHeader header;
         header.wrap(const_cast<char*>(reinterpret_cast<const char*>(buffer)), offset, 0, size);
 
         switch (header.templateId()) {
-        case 1: // ADMIN_HEARTBEAT
-            parse_admin_heartbeat(buffer + offset, size - offset);
-            break;
+        case utp_sbe::AdminHeartbeat::SBE_TEMPLATE_ID:
+            return parse_admin_heartbeat(buffer + offset, size - offset);
 
-        case 18: // SECURITY_DEFINITION
-            parse_security_definition(buffer + offset, size - offset);
-            break;
+        case utp_sbe::SecurityDefinition::SBE_TEMPLATE_ID:
+            return parse_security_definition(buffer + offset, size - offset);
 
-        case 39: // MD_FULL_REFRESH
-            parse_md_full_refresh(buffer + offset, size - offset);
-            break;
+        case utp_sbe::MDFullRefresh::SBE_TEMPLATE_ID:
+            return parse_md_full_refresh(buffer + offset, size - offset);
 
-        case 38: // MD_INCREMENTAL_REFRESH
-            parse_md_incremental_refresh(buffer + offset, size - offset);
-            break;
+        case utp_sbe::MDIncrementalRefresh::SBE_TEMPLATE_ID:
+            return parse_md_incremental_refresh(buffer + offset, size - offset);
 
-        case 41: // MD_INCREMENTAL_REFRESH_TRADES
-            parse_md_incremental_refresh_trades(buffer + offset, size - offset);
-            break;
+        case utp_sbe::MDIncrementalRefreshTrades::SBE_TEMPLATE_ID:
+            return parse_md_incremental_refresh_trades(buffer + offset, size - offset);
 
         default:
             std::cout << "Unsupported SBE message type: " << header.templateId() << std::endl;
@@ -309,6 +337,7 @@ void UTPClient::parse_sbe_message_at_offset(const uint8_t* buffer, size_t size,
     } catch (const std::exception& e) {
         std::cout << "Failed to parse SBE message at offset " << offset << ": " << e.what() << std::endl;
     }
+    return 0;
 }
 
 void UTPClient::decode_raw_message_content(const uint8_t* buffer, size_t size)
@@ -352,55 +381,31 @@ void UTPClient::decode_raw_message_content(const uint8_t* buffer, size_t size)
 
 void UTPClient::parse_message_at_offset(const uint8_t* buffer, size_t size, size_t offset)
 {
-    utp_sbe::MessageHeader header;
-    header.wrap(const_cast<char*>(reinterpret_cast<const char*>(buffer)), offset, 0, size);
-
     std::cout << "\n=== Parsing SBE Message at offset " << offset << " ===\n";
 
-    switch (header.templateId()) {
-    case 1: // ADMIN_HEARTBEAT
-        parse_admin_heartbeat(buffer + offset, size - offset);
-        break;
-
-    case 18: // SECURITY_DEFINITION
-        parse_security_definition(buffer + offset, size - offset);
-        break;
-
-    case 39: // MD_FULL_REFRESH
-        parse_md_full_refresh(buffer + offset, size - offset);
-        break;
-
-    case 38: // MD_INCREMENTAL_REFRESH
-        parse_md_incremental_refresh(buffer + offset, size - offset);
-        break;
-
-    case 41: // MD_INCREMENTAL_REFRESH_TRADES
-        parse_md_incremental_refresh_trades(buffer + offset, size - offset);
-        break;
-
-    default:
-        std::cout << "Unknown message type: " << header.templateId() << std::endl;
+    if (parse_sbe_message_at_offset(buffer, size, offset) == 0) {
         hex_dump(buffer + offset, std::min(size - offset, size_t(64)));
-        break;
     }
 }
 
-void UTPClient::parse_admin_heartbeat(const uint8_t* buffer, size_t size)
+size_t UTPClient::parse_admin_heartbeat(const uint8_t* buffer, size_t size)
 {
     utp_sbe::AdminHeartbeat heartbeat;
-    heartbeat.wrapForDecode(const_cast<char*>(reinterpret_cast<const char*>(buffer)),
-        0, sizeof(utp_sbe::MessageHeader),
-        sizeof(utp_sbe::MessageHeader), size);
+    char* data = const_cast<char*>(reinterpret_cast<const char*>(buffer));
+    utp_sbe::MessageHeader header(data, 0, size, 0);
+    heartbeat.wrapForDecode(data, header.encodedLength(), header.blockLength(), header.version(), size);
 
     std::cout << "AdminHeartbeat received\n";
+
+    return header.encodedLength() + heartbeat.decodeLength();
 }
 
-void UTPClient::parse_security_definition(const uint8_t* buffer, size_t size)
+size_t UTPClient::parse_security_definition(const uint8_t* buffer, size_t size)
 {
     utp_sbe::SecurityDefinition secDef;
-    secDef.wrapForDecode(const_cast<char*>(reinterpret_cast<const char*>(buffer)),
-        0, sizeof(utp_sbe::MessageHeader),
-        sizeof(utp_sbe::MessageHeader), size);
+    char* data = const_cast<char*>(reinterpret_cast<const char*>(buffer));
+    utp_sbe::MessageHeader header(data, 0, size, 0);
+    secDef.wrapForDecode(data, header.encodedLength(), header.blockLength(), header.version(), size);
 
     std::cout << "=== SecurityDefinition ===\n";
     std::cout << "  Security ID: " << secDef.securityID() << std::endl;
@@ -422,14 +427,16 @@ void UTPClient::parse_security_definition(const uint8_t* buffer, size_t size)
     std::cout << "  Security Type: " << static_cast<int>(secDef.securityType()) << std::endl;
     std::cout << "  Depth of Book: " << static_cast<int>(secDef.depthOfBook()) << std::endl;
     std::cout << "  Min Trade Volume: " << secDef.minTradeVol() << std::endl;
+
+    return header.encodedLength() + secDef.decodeLength();
 }
 
-void UTPClient::parse_md_full_refresh(const uint8_t* buffer, size_t size)
+size_t UTPClient::parse_md_full_refresh(const uint8_t* buffer, size_t size)
 {
     utp_sbe::MDFullRefresh refresh;
-    refresh.wrapForDecode(const_cast<char*>(reinterpret_cast<const char*>(buffer)),
-        0, sizeof(utp_sbe::MessageHeader),
-        sizeof(utp_sbe::MessageHeader), size);
+    char* data = const_cast<char*>(reinterpret_cast<const char*>(buffer));
+    utp_sbe::MessageHeader header(data, 0, size, 0);
+    refresh.wrapForDecode(data, header.encodedLength(), header.blockLength(), header.version(), size);
 
     std::cout << "=== MDFullRefresh ===\n";
     std::cout << "  Security ID: " << refresh.securityID() << std::endl;
@@ -449,14 +456,16 @@ void UTPClient::parse_md_full_refresh(const uint8_t* buffer, size_t size)
                   << " (0=Bid, 1=Offer), Price=" << price
                   << ", Size=" << entry.mDEntrySize() << std::endl;
     }
+
+    return header.encodedLength() + refresh.decodeLength();
 }
 
-void UTPClient::parse_md_incremental_refresh(const uint8_t* buffer, size_t size)
+size_t UTPClient::parse_md_incremental_refresh(const uint8_t* buffer, size_t size)
 {
     utp_sbe::MDIncrementalRefresh incremental;
-    incremental.wrapForDecode(const_cast<char*>(reinterpret_cast<const char*>(buffer)),
-        0, sizeof(utp_sbe::MessageHeader),
-        sizeof(utp_sbe::MessageHeader), size);
+    char* data = const_cast<char*>(reinterpret_cast<const char*>(buffer));
+    utp_sbe::MessageHeader header(data, 0, size, 0);
+    incremental.wrapForDecode(data, header.encodedLength(), header.blockLength(), header.version(), size);
 
     std::cout << "=== MDIncrementalRefresh ===\n";
     std::cout << "  Security ID: " << incremental.securityID() << std::endl;
@@ -476,14 +485,16 @@ void UTPClient::parse_md_incremental_refresh(const uint8_t* buffer, size_t size)
                   << " (0=Bid, 1=Offer), Price=" << price
                   << ", Size=" << entry.mDEntrySize() << std::endl;
     }
+
+    return header.encodedLength() + incremental.decodeLength();
 }
 
-void UTPClient::parse_md_incremental_refresh_trades(const uint8_t* buffer, size_t size)
+size_t UTPClient::parse_md_incremental_refresh_trades(const uint8_t* buffer, size_t size)
 {
     utp_sbe::MDIncrementalRefreshTrades trades;
-    trades.wrapForDecode(const_cast<char*>(reinterpret_cast<const char*>(buffer)),
-        0, sizeof(utp_sbe::MessageHeader),
-        sizeof(utp_sbe::MessageHeader), size);
+    char* data = const_cast<char*>(reinterpret_cast<const char*>(buffer));
+    utp_sbe::MessageHeader header(data, 0, size, 0);
+    trades.wrapForDecode(data, header.encodedLength(), header.blockLength(), header.version(), size);
 
     std::cout << "=== MDIncrementalRefreshTrades ===\n";
     std::cout << "  Security ID: " << trades.securityID() << std::endl;
@@ -502,6 +513,8 @@ void UTPClient::parse_md_incremental_refresh_trades(const uint8_t* buffer, size_
                   << ", Aggressor=" << static_cast<int>(entry.aggressorSide())
                   << " (0=None, 1=Buy, 2=Sell)" << std::endl;
     }
+
+    return header.encodedLength() + trades.decodeLength();
 }
 
 void UTPClient::parse_security_definition_tr(const uint8_t* buffer, size_t size, uint16_t block_length)
@@ -40,22 +40,25 @@ public:
     void set_incremental_refresh_callback(std::function<void(const MDIncrementalRefresh&)> callback);
 
 private:
+    static constexpr size_t TR_HEADER_SIZE = 20; // Thomson Reuters Binary Packet Header
+
     // Message parsing helpers
     void parse_message(const uint8_t* buffer, size_t size);
+    size_t parse_tr_packet(const uint8_t* buffer, size_t size); // Returns the messages parsed
     void parse_multicast_header(const uint8_t* buffer);
     void parse_tr_packet_header(const uint8_t* buffer);
     void parse_sbe_message(const uint8_t* buffer, size_t size);
-    void parse_sbe_message_at_offset(const uint8_t* buffer, size_t size, size_t offset);
+    size_t parse_sbe_message_at_offset(const uint8_t* buffer, size_t size, size_t offset); // Length, 0 = unknown
     void decode_raw_message_content(const uint8_t* buffer, size_t size);
     void parse_message_at_offset(const uint8_t* buffer, size_t size, size_t offset);
-    void parse_admin_heartbeat(const uint8_t* buffer, size_t size);
-    void parse_security_definition(const uint8_t* buffer, size_t size);
+    size_t parse_admin_heartbeat(const uint8_t* buffer, size_t size);
+    size_t parse_security_definition(const uint8_t* buffer, size_t size);
     void parse_security_definition_tr(const uint8_t* buffer, size_t size, uint16_t block_length);
-    void parse_md_full_refresh(const uint8_t* buffer, size_t size);
+    size_t parse_md_full_refresh(const uint8_t* buffer, size_t size);
     void parse_md_full_refresh_tr(const uint8_t* buffer, size_t size, uint16_t block_length);
-    void parse_md_incremental_refresh(const uint8_t* buffer, size_t size);
+    size_t parse_md_incremental_refresh(const uint8_t* buffer, size_t size);
     void parse_md_incremental_refresh_tr(const uint8_t* buffer, size_t size, uint16_t block_length);
-    void parse_md_incremental_refresh_trades(const uint8_t* buffer, size_t size);
+    size_t parse_md_incremental_refresh_trades(const uint8_t* buffer, size_t size);
 
     // Network helpers
     ssize_t receive_data(uint8_t* buffer, size_t max_size);